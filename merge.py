@@ -4,6 +4,10 @@ import sys
 
 local_include_regex = r'#include "([^"]+)"'
 cpp_extension = "cpp"
+# The game's source size limit.
+max_source_chars = 100000
+# Code under #ifdef of one of these is left out, along with what it includes: the merged bot is never built with them.
+offline_macros = ['CSB_PROFILE']
 
 
 def topo_dependencies(main_file):
@@ -29,33 +33,85 @@ def dfs(file, seen, res):
 
 def dependencies(file):
     with open(file) as f:
-        filetext = f.read()
+        filetext = drop_offline_code(f.read())
         headers = re.findall(local_include_regex, filetext)
         return headers
 
 
+def drop_offline_code(text):
+    """Drop the #ifdef branches of offline_macros, keeping their #else branches."""
+    out = []
+    # For each open conditional: whether it tests an offline macro, and whether its current branch is dropped.
+    stack = []
+    for line in text.split('\n'):
+        directive = line.strip()
+        dropping = any(dropped for (_, dropped) in stack)
+        if directive.startswith('#if'):
+            offline = re.match(r'#ifdef\s+(\w+)', directive) is not None and directive.split()[1] in offline_macros
+            stack.append((offline, offline))
+            if offline or dropping:
+                continue
+        elif directive.startswith('#else') or directive.startswith('#endif'):
+            (offline, _) = stack.pop()
+            if directive.startswith('#else'):
+                stack.append((offline, False))
+            if offline or dropping:
+                continue
+        elif dropping:
+            continue
+        out.append(line)
+    return '\n'.join(out)
+
+
 def matching_cpp_file(header_file):
     cpp_file = header_file.split('.')[0] + '.' + cpp_extension
     return cpp_file
 
 
+def strip_comments(text):
+    """Drop comments, blank lines and indentation, keeping string and character literals intact."""
+    out = []
+    i = 0
+    n = len(text)
+    while i < n:
+        c = text[i]
+        if c == '"' or c == "'":
+            j = i + 1
+            while j < n and text[j] != c:
+                j += 2 if text[j] == '\\' else 1
+            out.append(text[i:j + 1])
+            i = j + 1
+        elif text.startswith('//', i):
+            while i < n and text[i] != '\n':
+                i += 1
+        elif text.startswith('/*', i):
+            end = text.find('*/', i + 2)
+            i = n if end == -1 else end + 2
+            out.append(' ')
+        else:
+            out.append(c)
+            i += 1
+    lines = [line.strip() for line in ''.join(out).split('\n')]
+    return '\n'.join(line for line in lines if line) + '\n'
+
+
 def merge(main_file):
     header_files = topo_dependencies(main_file)
     cpp_files = []
     out = ""
     for header in header_files:
         with open(header) as hf:
-            filetext = hf.read()
+            filetext = drop_offline_code(hf.read())
             filetext = re.sub(local_include_regex, '', filetext)
-            out += filetext + '\n'
+            out += strip_comments(filetext)
 
     for cpp_file in cpp_files:
         if cpp_file == main_file:
             continue
         with open(cpp_file) as f:
-            filetext = f.read()
+            filetext = drop_offline_code(f.read())
             filetext = re.sub(local_include_regex, '', filetext)
-            out += filetext
+            out += strip_comments(filetext)
     return out
 
 cwd = os.getcwd()
@@ -66,4 +122,8 @@ combined = merge(tail)
 os.chdir(cwd)
 with open(sys.argv[2], 'w') as f:
     f.write(combined)
+if len(combined) > max_source_chars:
+    sys.stderr.write("error: %s is %d characters, over the game's limit of %d\n"
+                     % (sys.argv[2], len(combined), max_source_chars))
+    sys.exit(1)
 
@@ -4,227 +4,37 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <cstring>
-#include <assert.h>
-#include <limits>
-#include <cstdlib>
-#include <chrono>
 
-#include "State.h"
-#include "Bot.h"
-#include "Navigation.h"
-#include "Physics.h"
+#include "SearchBot.h"
 #include "OnlineMedian.h"
+#include "EditFilter.h"
+#include "ProfileScope.h"
 
 
-struct ScoreFactors {
-    // Racer
-    float overallRacer;
-    float passCPBonus;
-    float progressToCP;
-    float enemyProgress;
-    float earlyPassBonus;
-    // Bouncer
-    float overallBouncer;
-    float enemyDist;
-    float enemyDistToCP;
-    float bouncerDistToCP;
-    float angleSeenByCP;
-    float angleSeenByEnemy;
-    float bouncerTurnAngle;
-    float enemyTurnAngle;
-    float checkpointPenalty;
-    float skirtBonus;
-    float shieldPenalty;
-};
-
-static ScoreFactors defaultFactors = {
-        1,    // overallRacer
-        202, // passCPBonus
-        1.14,    // progressToCP
-        -0.80, // enemyProgress
-        1200, // earlyPassBonus
-        1,    // overallBouncer
-        -0.28, // enemyDist
-        1.87, // enemyDistToCP
-        -1.47,  // bouncerDistToCP
-        -0.78,  // angleSeenByCP
-        -0.134,  // angleSeenByEnemy
-        -0.528,  // bouncerTurnAngle
-        -0.448,  // enemyTurn angle
-        -4918,   // checkpoint penalty
-        2000,  // Skirt bonus
-        -200  // shield penalty
-};
-
-
-class CustomAI : public SimBot {
-    const PairOutput* moves;
-    Race& race;
-    int turn = 0;
-    int defaultAfter = -1;
-public:
-    CustomAI(Race& race, const PairOutput moves[], int startFromTurn) :
-            race(race), moves(moves), turn(startFromTurn) {}
-
-    void setTurn(int fromTurn) {
-        turn = fromTurn;
-    }
-
-    void move(PodState ourPods[], PodState enemyPods[]) {
-        Physics::apply(ourPods, moves[turn++]);
-    }
-};
-
 /**
- * Bot with very low computational requirements.
+ * Simulated annealing over one solution: each step edits one turn of it and keeps the edit by the Metropolis rule.
  */
-class MinimalBot : public SimBot {
-    Race race;
-    Physics physics;
-    Navigation nav;
-    static constexpr float angleThreshold = MAX_ANGLE;
-    static constexpr float cutOff = M_PI/2 + MAX_ANGLE;
-public:
-    MinimalBot() {}
-
-    MinimalBot(Race& race) {
-        init(race);
-    }
-
-    void init(Race& r) {
-        race = r;
-        physics = Physics(race);
-        nav = Navigation(race);
-    }
-
-    void moveBouncer(PodState* ourPods, PodState* enemyPods) {
-        // Bouncer
-        Vector target = race.checkpoints[enemyPods[0].nextCheckpoint];
-        float targetx;
-        float targety;
-        if((target.x - ourPods[1].pos.x)*(target.x - ourPods[1].pos.x) + (target.y - ourPods[1].pos.y) * (target.y - ourPods[1].pos.y) >
-           (target.x - enemyPods[0].pos.x)*(target.x - enemyPods[0].pos.x) + (target.y - enemyPods[0].pos.y)*(target.y - enemyPods[0].pos.y)) {
-            int nextNextCPID = race.followingCheckpoint(enemyPods[0].nextCheckpoint);
-            targetx = race.checkpoints[nextNextCPID].x;
-            targety = race.checkpoints[nextNextCPID].y;
-        }
-        else {
-            targetx = enemyPods[0].pos.x + (race.checkpoints[enemyPods[0].nextCheckpoint].x - enemyPods[0].pos.x) * 0.80;
-            targety = enemyPods[0].pos.y + (race.checkpoints[enemyPods[0].nextCheckpoint].y - enemyPods[0].pos.y) * 0.80;
-        }
-        target = Vector(targetx, targety);
-        float turnAngle = physics.turnAngle(ourPods[1],target);
-        Vector force;
-        if(abs(turnAngle) > MAX_ANGLE) {
-            float thrust = MAX_THRUST - int(((turnAngle - angleThreshold) / (cutOff - angleThreshold)) * MAX_THRUST);
-            turnAngle = turnAngle < 0 ? max(-MAX_ANGLE, turnAngle) : min(MAX_ANGLE, turnAngle);
-            force = Vector::fromMagAngle(thrust, turnAngle);
-        } else {
-            force = target.normalize() * MAX_THRUST;
-        }
-        ourPods[1].vel.x += force.x;
-        ourPods[1].vel.y += force.y;
-        ourPods[1].vel.resetLengths();
-        ourPods[1].addAngle(turnAngle);
-    }
-
-    void moveRacer(PodState* ourPods, PodState* enemyPods) {
-        // Racer
-        Vector drift = ourPods[0].vel * 3.5;
-        Vector target = race.checkpoints[ourPods[0].nextCheckpoint] - drift;
-        float turnAngle;
-        // It is possible that the target happens to be the pods position. This will cause a NaN to be returned from
-        // turnAngle(ourPods[0], target). Therefore, check for this case and use 0 instead.
-        static constexpr float closeEnough = 26;
-        if(Vector::distSq(ourPods[0].pos, target) < closeEnough) {
-            turnAngle = 0;
-        }else {
-            turnAngle = physics.turnAngle(ourPods[0], target);
-        }
-        Vector force;
-        if(abs(turnAngle) > MAX_ANGLE) {
-            float thrust = (int) MAX_THRUST - int(((turnAngle - angleThreshold) / (cutOff - angleThreshold)) * MAX_THRUST);
-            // Turn angle should be rounded to the nearest degree also.
-            turnAngle = turnAngle < 0 ? max(-MAX_ANGLE, turnAngle) : min(MAX_ANGLE, turnAngle);
-            force = Vector::fromMagAngle(thrust, turnAngle);
-        } else {
-            force = target.normalize() * MAX_THRUST;
-        }
-        ourPods[0].vel.x += force.x;
-        ourPods[0].vel.y += force.y;
-        ourPods[0].vel.resetLengths();
-        ourPods[0].addAngle(turnAngle);
-    }
-
-    /**
-     * ourPods and enemyPods must be orderd by progress; it is assumed that ourPods[0] is our lead pod.
-     */
-    void move(PodState* ourPods, PodState* enemyPods) {
-        moveRacer(ourPods, enemyPods);
-        moveBouncer(ourPods, enemyPods);
-    };
-};
-
-
 template<int TURNS>
-class CustomAIWithBackup : public SimBot {
-    const PairOutput* moves;
-    const PodState (*enemyStates)[2];
-    Race& race;
-    MinimalBot backup;
-    int turn;
-    int defaultAfter = -1;
-public:
-    CustomAIWithBackup(Race& race, const PairOutput moves[], const PodState enemyStates[TURNS][2], int startFromTurn):
-            race(race), moves(moves), enemyStates(enemyStates), backup(race), turn(startFromTurn) {}
+class AnnealingBot : public SearchBot<TURNS> {
+    using Base = SearchBot<TURNS>;
+    using Base::UNSET;
+    using Base::clockStart;
+    using Base::budget;
+    using Base::simCount;
+    using Base::rng;
+    using Base::previousSolution;
+    using Base::hasPrevious;
+    using Base::seeds;
+    using Base::seedCount;
+    using Base::enemySimHistory;
+    using Base::randomEdit;
+    using Base::randomSolution;
+    using Base::saveRollout;
+    using Base::restoreRollout;
+    using Base::editedPod;
+    using Base::getTimeMilli;
+    using Base::cache;
 
-    void setTurn(int fromTurn) {
-        turn = fromTurn;
-    }
-
-    void setDefaultAfter(int turn) {
-        defaultAfter = turn;
-    }
-
-    bool isEnemyRacerDataAccurate(int turn, PodState ourPods[], PodState enemyPods[]) {
-        float delta = Vector::dist(enemyStates[turn][0].pos, enemyPods[0].pos);
-        float distToEnemy = Vector::dist(ourPods[1].pos, enemyPods[0].pos);
-        return delta / distToEnemy < 2.0;
-    }
-
-    bool isEnemyBouncerDataAccurate(int turn, PodState ourPods[], PodState enemyPods[]) {
-        float delta = Vector::dist(enemyStates[turn][1].pos, enemyPods[1].pos);
-        float distToEnemy = Vector::dist(ourPods[0].pos, enemyPods[1].pos);
-        return delta / distToEnemy < 2.0;
-    }
-
-    void move(PodState ourPods[], PodState enemyPods[]) {
-        if(defaultAfter != -1 && turn >= defaultAfter) {
-            backup.move(ourPods, enemyPods);
-        } else {
-            if(isEnemyBouncerDataAccurate(turn, ourPods, enemyPods)) {
-                Physics::apply(ourPods[0], moves[turn].o1);
-            } else {
-                backup.moveRacer(ourPods, enemyPods);
-            }
-            if(isEnemyRacerDataAccurate(turn, ourPods, enemyPods)) {
-                Physics::apply(ourPods[1], moves[turn].o2);
-            } else {
-                backup.moveBouncer(ourPods, enemyPods);
-            }
-        }
-        turn++;
-    }
-};
-
-template<int TURNS>
-class AnnealingBot : public DuelBot {
-public:
-    ScoreFactors sFactors = defaultFactors;
-    bool isControl = false;
-private:
-    static constexpr float maxScore = 400000;//numeric_limits<float>::infinity();
-    static constexpr float minScore = 10000;//-numeric_limits<float>::infinity();
     // Loop control and timing.
     static const int reevalPeriodMilli = 4;
     static const int timeBufferMilli = 1;
@@ -236,11 +46,8 @@ private:
     static const int initCoolingSteps = 160;
     static const int initStepsPerTemp = 140;
     long long startTime;
-    static const int UNSET = -1;
-    long allocatedTime = UNSET;
     long long lastUpdateTime;
     double diffSum = 0;
-    int simCount = 0;
     int tunnelCount = 0;
     int nonTunnelCount = 0;
     int simsSinceUpdate = 0;
@@ -250,44 +57,30 @@ private:
     int stepsPerTemp = initStepsPerTemp;
     float currentTemp = initTemp;
     float coolingFraction = UNSET;//initCoolingFraction;
-    bool toDeleteEnemy = false;
     // SD & mean
     float mean;
     double M2;
     OnlineMedian<float> onlineMedian;
 
 
-    Race race;
-    Physics physics;
-    SimBot* enemyBot;
-    PairOutput previousSolution[TURNS];
-    bool hasPrevious = false;
-    PodState enemySimHistory[TURNS + 1][POD_COUNT];
-    PodState ourSimHistory[TURNS + 1][POD_COUNT];
-
-    void _train(const PodState podsToTrain[], const PodState opponentPods[], PairOutput solution[], PodState* enemyPodState);
-
-    float score(const PairOutput solution[], int startFromTurn);
-
-    void simulate(SimBot *pods1Sim, SimBot *pods2Sim, int turns, int startFromTurn);
-
-    void randomSolution(PairOutput sol[]);
-
-    PairOutput random();
-
-    void randomEdit(PairOutput &po);//, int turnsRemaining, float algoProgress);
-
-    long long getTimeMilli() {
-        long long ms = chrono::duration_cast<chrono::milliseconds>(
-                chrono::system_clock::now().time_since_epoch()).count();
-        return ms;
+    void updateLoopControl() {
+        PROFILE_SCOPE(LOOP_CONTROL);
+        switch(budget.kind) {
+            case SearchBudget::UNSET:
+                return;
+            case SearchBudget::TIME:
+                updateTimedLoopControl();
+                return;
+            default:
+                // The length of the schedule was fixed by init(); only the temperatures follow the scores seen so far.
+                if(coolingIdx >= 1) calibrateTemperature();
+        }
     }
 
-    void updateLoopControl() {
-        if (allocatedTime == UNSET) return;
+    void updateTimedLoopControl() {
         long long timeNow = getTimeMilli();
         long elapsed = timeNow - lastUpdateTime;
-        long timeRemaining = allocatedTime - (timeNow - startTime) - timeBufferMilli;
+        long timeRemaining = budget.amount - (timeNow - startTime) - timeBufferMilli;
         if (timeRemaining < 0) {
             coolingSteps = 0;
             stepsPerTemp = 0;
@@ -310,27 +103,48 @@ private:
 //            cerr << "Steps per temp: " << stepsPerTemp << endl;
         }
         if(elapsed > reevalPeriodMilli || coolingIdx == 1) {
-            // T0 = -sd/ln(startAcceptanceRate)    [from startAcceptanceRate = exp(-sd/T0)]
-            float SD = sqrt(M2/simCount);
-//            cerr << "SD: " << SD << endl;
-            float median = onlineMedian.median();
-//            cerr << "mean: " << mean << "    median: " << median << endl;
-            float startTemp = -median/log(startAcceptanceRate);
-            float endTemp = -median/log(endAcceptanceRate);
-            coolingFraction = pow(endTemp/startTemp, 1.0/(coolingSteps*0.6));
-            currentTemp = startTemp*pow(coolingFraction, coolingIdx);
-//            cerr << "Current Temp: " << currentTemp << "    coolingIdx: " << coolingIdx << endl;
-//            cerr << "Cooling Fraction: " << coolingFraction  << "     Cooling steps: " << coolingSteps << endl;
+            calibrateTemperature();
         }
     }
 
+    void calibrateTemperature() {
+        // T0 = -sd/ln(startAcceptanceRate)    [from startAcceptanceRate = exp(-sd/T0)]
+        float SD = sqrt(M2/simCount);
+//        cerr << "SD: " << SD << endl;
+        float median = onlineMedian.median();
+//        cerr << "mean: " << mean << "    median: " << median << endl;
+        float startTemp = -median/log(startAcceptanceRate);
+        float endTemp = -median/log(endAcceptanceRate);
+        coolingFraction = pow(endTemp/startTemp, 1.0/(coolingSteps*0.6));
+        currentTemp = startTemp*pow(coolingFraction, coolingIdx);
+//        cerr << "Current Temp: " << currentTemp << "    coolingIdx: " << coolingIdx << endl;
+//        cerr << "Cooling Fraction: " << coolingFraction  << "     Cooling steps: " << coolingSteps << endl;
+    }
+
     void init() {
-        startTime = getTimeMilli();
-        lastUpdateTime = startTime;
+        lastUpdateTime = getTimeMilli();
+        startTime = clockStart == UNSET ? lastUpdateTime : clockStart;
+        clockStart = UNSET;
         currentTemp = initTemp;
-        coolingSteps = allocatedTime == UNSET ? initCoolingSteps : allocatedTime * 1.2;
         coolingFraction = initCoolingFraction;
-        stepsPerTemp = initStepsPerTemp;
+        switch(budget.kind) {
+            case SearchBudget::TIME:
+                coolingSteps = budget.amount * 1.2;
+                stepsPerTemp = initStepsPerTemp;
+                break;
+            case SearchBudget::ROLLOUTS:
+                // Same shape as the timed schedule settles on, sized so that all steps fit within the budget.
+                coolingSteps = max(1, (int) sqrt(this->rolloutBudget() / stepsVsCoolRatio));
+                stepsPerTemp = max(1, (int) (this->rolloutBudget() / (coolingSteps + 1)));
+                break;
+            case SearchBudget::COOLING_STEPS:
+                coolingSteps = budget.amount;
+                stepsPerTemp = max(1, (int) (coolingSteps * stepsVsCoolRatio));
+                break;
+            default:
+                coolingSteps = initCoolingSteps;
+                stepsPerTemp = initStepsPerTemp;
+        }
         simCount = 0;
         tunnelCount = 0;
         nonTunnelCount = 0;
@@ -341,212 +155,22 @@ private:
         mean = 0;
 //        M2 = 0;
         onlineMedian = OnlineMedian<float>();
+        if(editScreen) editScreen->reset();
+        cache.clear();
     }
 
-public:
-    AnnealingBot() {
-    }
-
-    AnnealingBot(Race &r) : race(r), physics(race) {
-        enemyBot = new MinimalBot(race);
-        toDeleteEnemy = true;
-    }
-
-    AnnealingBot(Race &r, long allocatedTimeMilli) : race(r), physics(race), allocatedTime(allocatedTimeMilli) {
-        enemyBot = new MinimalBot(race);
-        toDeleteEnemy = true;
-    }
-
-    AnnealingBot(Race &r, long allocatedTimeMilli, SimBot* enemyBot) :
-            race(r), physics(race), allocatedTime(allocatedTimeMilli), enemyBot(enemyBot) {
-    }
-
-    ~AnnealingBot() {
-        if(toDeleteEnemy) {
-            delete (enemyBot);
-        }
-    }
-
-    void setEnemyAI(SimBot* enemyAI) {
-        if(toDeleteEnemy) delete(enemyBot);
-        enemyBot = enemyAI;
-        toDeleteEnemy = false;
-
-    }
-
-    void setInnitialSolution(PairOutput po[]) {
-        memcpy(previousSolution, po, sizeof(PairOutput) * TURNS);
-        hasPrevious = true;
-    }
-
-    float score(const PodState *pods[], const PodState *podsPrev[], const PodState *enemyPods[],
-                const PodState *enemyPodsPrev[]);
-
-    bool train(const PodState pods[], const PodState enemyPods[], PairOutput solution[], PodState* enemyPodState) {
-        init();
-        PodState ourPodsCopy[POD_COUNT];
-        PodState enemyPodsCopy[POD_COUNT];
-        memcpy(ourPodsCopy, pods, sizeof(PodState) * POD_COUNT);
-        memcpy(enemyPodsCopy, enemyPods, sizeof(PodState) * POD_COUNT);
-        bool switched = physics.orderByProgress(ourPodsCopy);
-        physics.orderByProgress(enemyPodsCopy);
-        _train(ourPodsCopy, enemyPodsCopy, solution, enemyPodState);
-        return switched;
-    }
-
-    PairOutput move(GameState& gameState) {
-        PairOutput solution[TURNS];
-//        if(gameState.turn == 0) {
-//            gameState.ourState().pods[0].vel += (race.checkpoints[1] - gameState.ourState().pods[0].pos).normalize() * BOOST_ACC;
-//            gameState.ourState().pods[1].vel += (race.checkpoints[1] - gameState.ourState().pods[1].pos).normalize() * BOOST_ACC;
-//            gameState.enemyState().pods[0].vel += (race.checkpoints[1] - gameState.enemyState().pods[0].pos).normalize() * BOOST_ACC;
-//            gameState.enemyState().pods[1].vel += (race.checkpoints[1] - gameState.enemyState().pods[1].pos).normalize() * BOOST_ACC;
-//        }
-        PodState enemyPodState[TURNS][2] ;
-        bool switched = train(gameState.ourState().pods, gameState.enemyState().pods, solution, enemyPodState[0]);
-        // Enable boost
-        PodState bouncer = gameState.ourState().pods[1];
-        PodState racer = gameState.ourState().pods[0];
-        PodState enemyRacer = gameState.enemyState().pods[0];
-        // Racer
-        if(gameState.ourState().pods[0].boostAvailable &&
-                solution[0].o1.thrust == MAX_THRUST && solution[0].o1.thrust == MAX_THRUST) {
-            bool shieldUsed = false;
-            for(int i = 0; i < TURNS; i++) {
-                if(solution[TURNS].o1.shieldEnabled) {
-                    shieldUsed = true;
-                    break;
-                }
-            }
-            if(!shieldUsed) {
-                static constexpr float minimumDistFactor = 0.7f;
-                static constexpr float boostAngleLimit = M_PI * (5.0f / 180.0f);
-                float distThreshold = gameState.race.maxCheckpointDist * minimumDistFactor;
-                if(Vector::dist(race.checkpoints[racer.nextCheckpoint], racer.pos) > distThreshold) {
-                    if(abs(physics.turnAngle(racer, race.checkpoints[racer.nextCheckpoint]) < boostAngleLimit)) {
-                        solution[0].o1.boostEnabled = true;
-                    }
-                }
-            }
-        }
-        // Bouncer
-        if(gameState.ourState().pods[1].boostAvailable) {
-            if(!solution[0].o2.shieldEnabled && solution[0].o2.thrust == MAX_THRUST && solution[1].o2.shieldEnabled) {
-                if(Vector::distSq(bouncer.pos, enemyRacer.pos) < 3000*3000) {
-                    static constexpr float boostAngleLimit = M_PI * (5.0f / 180.0f);
-                    if (abs(physics.turnAngle(bouncer, enemyRacer.pos) < boostAngleLimit) &&
-                        abs(physics.turnAngle(enemyRacer, bouncer.pos)) < 2 * boostAngleLimit) {
-                        solution[0].o2.boostEnabled = true;
-                    }
-                }
-            }
-        }
-        if (switched) {
-            PodOutputSim temp;
-            for(int i = 0; i < TURNS; i++) {
-                temp = solution[i].o1;
-                solution[i].o1 = solution[i].o2;
-                solution[i].o2 = temp;
-            }
-        }
-        return solution[0];
-    }
-
-    static PodOutputSim getByIdx(PairOutput po, int i) {
-        if(i == 0) return po.o1;
-        else return po.o2;
-    }
-
-
-    float progress(const PodState *pod, const PodState *previous);
+    void _train(const PodState podsToTrain[], const PodState opponentPods[], PairOutput solution[], PodState* enemyPodState);
 
-    float scoreBenchmark(const PodState **pods, const PodState **podsPrev, const PodState **enemyPods,
-                         const PodState **enemyPodsPrev);
+public:
+    using Base::Base;
 
-    float bouncerScore(const PodState *bouncer, const PodState *target, const PodState *targetPrev);
+    // The annealer skips the rollouts of edits this is confident it would reject, if set (see EditScreen).
+    EditFilter* editScreen = nullptr;
 };
 
-
-template<int TURNS>
-PairOutput AnnealingBot<TURNS>::random() {
-    int randomSpeed = rand() % (MAX_THRUST + 1);
-//    int randomSpeed = ((float)rand() / RAND_MAX) > 0.5 ? 0 : MAX_THRUST;
-    float randomAngle = Physics::degreesToRad(-18 + rand() % (MAX_ANGLE_DEG * 2 + 1));
-    bool shieldEnabled = false;
-    PodOutputSim o1(randomSpeed, randomAngle, shieldEnabled, false);
-
-    randomSpeed = rand() % (MAX_THRUST + 1);
-//    randomSpeed = ((float)rand() / RAND_MAX) > 0.5 ? 0 : MAX_THRUST;
-    randomAngle = Physics::degreesToRad(-18 + rand() % (MAX_ANGLE_DEG * 2 + 1));
-    PodOutputSim o2(randomSpeed, randomAngle, shieldEnabled, false);
-    return PairOutput(o1, o2);
-}
-
-template<int TURNS>
-void AnnealingBot<TURNS>::randomEdit(PairOutput& po) {//, int turnsRemaining, float algoProgress) {
-    static const int MAX_DIST = 1000;
-    static const int MIN_DIST = 30;
-//    float dist = MAX_DIST - algoProgress * (MAX_DIST - MIN_DIST);
-    float sw = (float) rand() / RAND_MAX;
-    float flip = (float) rand() /RAND_MAX;
-//    float thrustFactor = (1/(1-DRAG) - pow(DRAG, turnsRemaining)/(1-DRAG));
-//    static const int averageVel = 600;
-//    float angleFactor = M_PI  * averageVel * turnsRemaining;
-//    float angleDelta = dist / angleFactor;
-//    int thrustDelta = (int) dist / thrustFactor;
-//    float angle;
-    if(sw < 5.0/32.0) {
-        po.o1.thrust = max(0, min(MAX_THRUST, (rand() % (400 + 1) - 100)));
-//        if(po.o1.thrust == MAX_THRUST || flip < 0.5) {
-//            po.o1.thrust = max(0, po.o1.thrust - thrustDelta);
-//        } else {
-//            po.o1.thrust = min(MAX_THRUST, po.o1.thrust + thrustDelta);
-//        }
-        po.o1.shieldEnabled = false;
-    } else if(sw < 10.0/32.0) {
-        po.o2.thrust = max(0, min(MAX_THRUST, (rand() % (600 + 1) - 200)));
-//        if(po.o2.thrust == MAX_THRUST || flip < 0.5) {
-//            po.o2.thrust = max(0, po.o2.thrust - thrustDelta);
-//        } else {
-//            po.o2.thrust = min(MAX_THRUST, po.o2.thrust + thrustDelta);
-//        }
-        po.o2.shieldEnabled = false;
-    } else if(sw < 20.0/32.0) {
-        po.o1.angle = max(-MAX_ANGLE, min(MAX_ANGLE, physics.degreesToRad(-25 + rand() % (50 + 1))));
-//        if(po.o1.angle == MAX_ANGLE || flip < 0.5) {
-//            po.o1.angle = max(-MAX_ANGLE, po.o1.angle - angleDelta);
-//        } else {
-//            po.o1.angle = min(MAX_ANGLE, po.o1.angle + angleDelta);
-//        }
-    } else if(sw < 30.0/32.0) {
-        po.o2.angle = max(-MAX_ANGLE, min(MAX_ANGLE, physics.degreesToRad(-25 + rand() % (50 + 1))));
-//        if(po.o2.angle == MAX_ANGLE || flip < 0.5) {
-//            po.o2.angle = max(-MAX_ANGLE, po.o2.angle - angleDelta);
-//        } else {
-//            po.o2.angle = min(MAX_ANGLE, po.o2.angle + angleDelta);
-//        }
-    } else if(sw < 31.0/32.0) {
-        po.o1.shieldEnabled = true;
-        po.o1.thrust = 0;
-    } else if(sw < 1.0) {
-        po.o2.shieldEnabled = true;
-        po.o2.thrust = 0;
-    }
-}
-
-template<int TURNS>
-void AnnealingBot<TURNS>::randomSolution(PairOutput sol[]) {
-    for(int i = 0; i < TURNS; i++) {
-        sol[i] = random();
-    }
-}
-
 template<int TURNS>
 void AnnealingBot<TURNS>::_train(const PodState podsToTrain[], const PodState opponentPods[], PairOutput solution[], PodState* enemyPodState) {
-    ourSimHistory[0][0] = podsToTrain[0];
-    ourSimHistory[0][1] = podsToTrain[1];
-    enemySimHistory[0][0] = opponentPods[0];
-    enemySimHistory[0][1] = opponentPods[1];
+    this->setStart(podsToTrain, opponentPods);
     double exponent;
     double merit, flip;
     if(hasPrevious) {
@@ -557,14 +181,40 @@ void AnnealingBot<TURNS>::_train(const PodState podsToTrain[], const PodState op
     } else {
         randomSolution(solution);
     }
-    float currentScore = score(solution, 0);
+    float currentScore = this->score(solution, 0);
+    // Start from a seed instead if one scores better.
+    int bestSeed = -1;
+    for(int s = 0; s < seedCount; s++) {
+        float seedScore = this->score(seeds[s], 0);
+        simCount++;
+        if(seedScore < currentScore) {
+            currentScore = seedScore;
+            bestSeed = s;
+        }
+    }
+    if(bestSeed != -1) {
+        memcpy(solution, seeds[bestSeed], TURNS * sizeof(PairOutput));
+    }
+    if(seedCount > 0) {
+        // The edits resimulate from the last rollout, which has to be the starting solution's.
+        currentScore = this->score(solution, 0);
+    }
     float bestScore = currentScore;
     float updated_score;
     float startScore;
     float delta;
     int toEdit = 0;
     PairOutput saved;
+    // The hash of the solution, for the score cache, and of the edited one.
+    uint64_t key = ScoreCache::hash(solution, TURNS);
+    uint64_t editedKey;
+    bool cached;
+    if(this->useScoreCache) {
+        cache.store(key, currentScore);
+    }
+    // The start is the best so far: with a good seed, it may be what the search ends with.
     PairOutput best[TURNS];
+    memcpy(best, solution, TURNS * sizeof(PairOutput));
     // SD & mean
     mean = 0;
 //    onlineMedian.add(0.0f);
@@ -579,7 +229,27 @@ void AnnealingBot<TURNS>::_train(const PodState podsToTrain[], const PodState op
             toEdit = (toEdit + 1) % TURNS;//rand() % TURNS;
             saved = solution[toEdit];
             randomEdit(solution[toEdit]);//, TURNS - toEdit, ((float)coolingIdx)/coolingSteps);
-            updated_score =  score(solution, toEdit);
+            float progress = (float) coolingIdx / max(1, coolingSteps);
+            editedKey = key ^ ScoreCache::turnHash(toEdit, saved) ^ ScoreCache::turnHash(toEdit, solution[toEdit]);
+            cached = this->useScoreCache && cache.lookup(editedKey, progress, updated_score);
+            if(!cached) {
+                if(editScreen) {
+                    editScreen->describe(saved, solution[toEdit], toEdit, progress);
+                    if(!editScreen->shouldRollOut()) {
+                        // Rejected unseen: the last rollout is still the solution's.
+                        solution[toEdit] = saved;
+                        nonTunnelCount++;
+                        simCount++;
+                        simsSinceUpdate++;
+                        continue;
+                    }
+                }
+                saveRollout(toEdit);
+                updated_score = this->score(solution, toEdit, editedPod(saved, solution[toEdit]));
+                if(this->useScoreCache) {
+                    cache.store(editedKey, updated_score);
+                }
+            }
             if(updated_score < 0) {
                 cerr << "Score below zero  " << updated_score << endl;
             }
@@ -614,11 +284,12 @@ void AnnealingBot<TURNS>::_train(const PodState podsToTrain[], const PodState op
             if(merit != 1 && (coolingIdx == coolingSteps || coolingSteps == 0)) {
                 merit = 0;
             }
+            bool accepted = true;
             if(delta < 0) {
                 currentScore += delta;
             } else {
                 // Used for random variable with mean 0.5.
-                flip = ((float) rand() / (RAND_MAX));
+                flip = rng.nextFloat();
                 if(merit > flip) {
                     currentScore += delta;
                     tunnelCount++;
@@ -626,8 +297,22 @@ void AnnealingBot<TURNS>::_train(const PodState podsToTrain[], const PodState op
                     nonTunnelCount++;
                     // transition back.
                     solution[toEdit] = saved;
+                    if(!cached) {
+                        restoreRollout(toEdit);
+                    }
+                    accepted = false;
                 }
             }
+            if(accepted) {
+                key = editedKey;
+                if(cached) {
+                    // The last rollout is still the previous solution's; the next edits resimulate from this one's.
+                    this->score(solution, toEdit, editedPod(saved, solution[toEdit]));
+                }
+            }
+            if(editScreen && !cached) {
+                editScreen->learn(accepted);
+            }
             simCount++;
             simsSinceUpdate++;
         }
@@ -648,229 +333,4 @@ void AnnealingBot<TURNS>::_train(const PodState podsToTrain[], const PodState op
     memcpy(enemyPodState, enemySimHistory, TURNS*sizeof(PodState)*2);
     hasPrevious = true;
 }
-
-template<int TURNS>
-float AnnealingBot<TURNS>::score(const PairOutput solution[], int startFromTurn) {
-    CustomAI *customAI = new CustomAI(race, solution, startFromTurn);
-    enemyBot->setTurn(startFromTurn);
-    simulate(customAI, enemyBot, TURNS, startFromTurn);
-    delete (customAI);
-    const PodState* ourPods[] = {&ourSimHistory[TURNS][0], &ourSimHistory[TURNS][1]};
-    const PodState* ourPodsPrev[] = {&ourSimHistory[0][0], &ourSimHistory[0][1]};
-    const PodState* enemyPods[] = {&enemySimHistory[TURNS][0], &enemySimHistory[TURNS][1]};
-    const PodState* enemyPodsPrev[] = {&enemySimHistory[0][0], &enemySimHistory[0][1]};
-    if(isControl) {
-        return scoreBenchmark(ourPods, ourPodsPrev, enemyPods, enemyPodsPrev);
-    } else {
-        return score(ourPods, ourPodsPrev, enemyPods, enemyPodsPrev);
-    }
-}
-
-template<int TURNS>
-float AnnealingBot<TURNS>::score(const PodState* pods[], const PodState* podsPrev[], const PodState* enemyPods[], const PodState* enemyPodsPrev[]) {
-    const int totalCPs = race.totalCPCount();
-
-    if(pods[0]->passedCheckpoints == totalCPs) {
-        for(int i = 1; i <= TURNS; i++) {
-            if(ourSimHistory[0][i].passedCheckpoints == totalCPs) {
-                return minScore + i * 5000;
-            }
-        }
-    }
-    if(enemyPods[0]->passedCheckpoints == totalCPs) {
-        for(int i = 1; i <= TURNS; i++) {
-            if(enemySimHistory[0][i].passedCheckpoints == totalCPs) {
-                return maxScore  - i * 5000;
-            }
-        }
-    }
-    if(pods[0]->turnsSinceCP >= WANDER_TIMEOUT && pods[1]->turnsSinceCP >= WANDER_TIMEOUT) {
-        return maxScore;
-    }
-    if(enemyPods[0]->turnsSinceCP >= WANDER_TIMEOUT && enemyPods[1]->turnsSinceCP >= WANDER_TIMEOUT) {
-        return minScore;
-    }
-
-    // Racer
-    float racerScore = progress(pods[0], podsPrev[0]);
-    float chaserScore = 0;
-    if(min(enemyPodsPrev[0]->turnsSinceCP, enemyPodsPrev[1]->turnsSinceCP) < podsPrev[0]->turnsSinceCP && podsPrev[0]->turnsSinceCP > 50 + TURNS && enemyPods[0]->passedCheckpoints < race.totalCPCount() - 1) {
-        chaserScore -=  0.6*Vector::dist(pods[0]->pos, pods[1]->pos);
-        chaserScore += 0.4*Vector::dist(enemyPods[1]->pos, pods[0]->pos);
-        chaserScore += 0.2*Vector::dist(enemyPods[0]->pos, pods[0]->pos);
-    } else {
-        chaserScore = bouncerScore(pods[1], enemyPods[0], enemyPodsPrev[0]);
-        racerScore += sFactors.enemyProgress*progress(enemyPods[0], enemyPodsPrev[0]);
-    }
-//    Vector toCPTangent = (race.checkpoints[pods[0]->nextCheckpoint] - pods[0]->pos).tanget().normalize();
-//    racerScore += min(3500.0f, 70*abs((toCPTangent.project(pods[0]->vel) - toCPTangent.project(enemyPods[1]->vel)).getLengthSq()));
-    int startCP = podsPrev[0]->nextCheckpoint;
-    if(Vector::distSq(enemyPodsPrev[1]->pos, race.checkpoints[startCP]) < Vector::distSq(podsPrev[0]->pos, race.checkpoints[startCP]) && Vector::distSq(enemyPodsPrev[1]->pos, podsPrev[0]->pos) < 3000*3000) {
-        for(int i = 0; i < TURNS; i++) {
-            if(ourSimHistory[i+1][0].nextCheckpoint != startCP || Vector::distSq(enemySimHistory[i+1][1].pos, race.checkpoints[startCP]) > Vector::distSq(ourSimHistory[i+1][0].pos, race.checkpoints[startCP])+400) {
-                racerScore += sFactors.skirtBonus * (TURNS - i);
-                break;
-            }
-        }
-    }
-    // Testing
-//    racerScore -= min(3000.0, 0.033*(race.checkpoints[pods[0]->nextCheckpoint] - pods[0]->pos).normalize().project(pods[0]->vel).getLengthSq());
-    float score = 200000-(racerScore*sFactors.overallRacer + chaserScore*sFactors.overallBouncer);
-    return score;
-}
-
-template<int TURNS>
-float AnnealingBot<TURNS>::progress(const PodState* pod, const PodState* previous) {
-    // Range: [0, 20000]
-    static const int PASS_CP_BONUS = sFactors.passCPBonus;
-    int ourNextCPID = pod->nextCheckpoint;
-    int ourCurCPID = previous->nextCheckpoint;
-    Vector ourNextCP = race.checkpoints[ourNextCPID];
-    Vector ourCurCP = race.checkpoints[ourCurCPID];
-    float progress = -Vector::dist(pod->pos, race.checkpoints[pod->nextCheckpoint]) + 20000 * (pod->passedCheckpoints - previous->passedCheckpoints);
-//    float progress = sFactors.progressToCP * (race.distFromPrevCP(ourNextCPID) - Vector::dist(pod->pos, ourNextCP));
-    for(int i = 0; i < TURNS; i++) {
-        if(ourSimHistory[i+1][0].nextCheckpoint != ourSimHistory[i][0].nextCheckpoint) {
-            progress += sFactors.passCPBonus;
-//            progress += sFactors.progressToCP * race.distFromPrevCP(ourSimHistory[i][0].nextCheckpoint);
-            progress += sFactors.earlyPassBonus * (TURNS - i);
-        }
-    }
-//    int i = ourCurCPID;
-//    while(i != ourNextCPID) {
-//        progress += sFactors.passCPBonus;
-//        progress += sFactors.progressToCP * race.distFromPrevCP(i);
-//        i = race.followingCheckpoint(i);
-//    }
-    progress -= max(0, TURNS -pod->turnsSinceShield)*sFactors.shieldPenalty;
-    return progress;
-}
-
-
-static float timeFromDVA(float distance, float velocity, float acc) {
-    return (-velocity + sqrt(velocity*velocity - 2*acc*distance)) / acc;
-}
-
-static float sigmoid(float x) {
-    return x / (3*(1 + abs(x)));
-}
-
-static constexpr float MAX_DIST = 30000.0f;
-
-template<int TURNS>
-float AnnealingBot<TURNS>::bouncerScore(const PodState *bouncer, const PodState *target, const PodState *targetPrev) {
-    float score = 0;
-    int targetCP = target->nextCheckpoint;
-    bool next = false;
-    if(targetPrev->passedCheckpoints != race.totalCPCount() -1 && Vector::dist(ourSimHistory[0][1].pos, race.checkpoints[targetPrev->nextCheckpoint]) > Vector::dist(targetPrev->pos, race.checkpoints[targetPrev->nextCheckpoint]) + 500) {
-        targetCP = race.followingCheckpoint(targetPrev->nextCheckpoint);
-        next = true;
-    }
-    Vector enemyCPDiff = target->pos - race.checkpoints[targetCP];
-    Vector bouncerCPDiff = bouncer->pos - race.checkpoints[targetCP];
-    Vector enemyBouncerDiff = bouncer->pos - target->pos;
-    static const int TOO_CLOSE = 50;
-    float angleSeenByCP = bouncerCPDiff.getLength() <= TOO_CLOSE ? 0 : 637.0f * (abs(physics.angleBetween(enemyCPDiff, bouncerCPDiff)) - M_PI/2.0f);
-    float angleSeenByEnemy = bouncerCPDiff.getLength() <= TOO_CLOSE ? 0 : 637.0f * (abs(physics.angleBetween(race.checkpoints[targetCP] - target->pos, bouncer->pos - target->pos)) - M_PI/2.0f);
-//    float angleDiff = 637.0f * abs(physics.turnAngle(*bouncer, target->pos) + physics.turnAngle(*target, bouncer->pos));
-    float bouncerTurnAngle = 637.0f * (abs(physics.turnAngle(*bouncer, target->pos)) - M_PI/2.0f);
-    float enemyTurnAngle = 637.0f * (abs(physics.turnAngle(*target, bouncer->pos)) - M_PI/2.0f);
-    float checkpointPenalty = target->passedCheckpoints > targetPrev->passedCheckpoints ? 1 : 0;
-
-    score += sFactors.bouncerDistToCP * (-4000 + min(MAX_DIST, bouncerCPDiff.getLength())) +
-            sFactors.bouncerTurnAngle * bouncerTurnAngle;
-    score += max(0, TURNS-bouncer->turnsSinceShield) * sFactors.shieldPenalty;
-
-    if(!next) {
-        score += sFactors.enemyDistToCP * (-4000 + min(MAX_DIST, enemyCPDiff.getLength())) +
-                 sFactors.angleSeenByCP * angleSeenByCP +
-                 sFactors.angleSeenByEnemy * angleSeenByEnemy +
-                 //                sFactors.angleSeenByEnemy * angleDiff +
-                 sFactors.enemyTurnAngle * enemyTurnAngle +
-                 sFactors.enemyDist * (-3000 + min(MAX_DIST, enemyBouncerDiff.getLength())) +
-                 sFactors.checkpointPenalty * checkpointPenalty;
-        // Testing
-//        Vector toCPTangent = (race.checkpoints[targetCP] - target->pos).tanget().normalize();
-//        if(Vector::distSq(bouncer->pos, target->pos) < 3000*3000) {
-//            score -= min(3500.0f, sFactors.tangentVelBonus * abs((toCPTangent.project(target->vel) - toCPTangent.project(bouncer->vel)).getLengthSq()));
-//        }
-    }
-//    score += ourSimHistory[0][1].nextCheckpoint != ourSimHistory[TURNS][1].nextCheckpoint ? 200 : 0;
-
-//    if(!(score <= 0 || score >= 0)) {
-//        cerr << "NaN for bouncer score." << endl;
-//        cerr << "angleSeenByCP " << angleSeenByCP << endl;
-//        cerr << "angleSeenByEnemy " << angleSeenByEnemy << endl;
-//        cerr << "bouncerTurnAngle"  << bouncerTurnAngle << endl;
-//        cerr << "enemyTurnAngle " << enemyTurnAngle << endl;
-//        cerr << "enemyCPDiff " << enemyCPDiff.getLength() << endl;
-//        cerr << "bouncerCPDiff " << bouncerCPDiff.getLength() << endl;
-//        cerr << "enemyBouncerDiff " << enemyBouncerDiff.getLength() << endl;
-//        cerr << "bouncer pos " << bouncer->pos << endl;
-//        cerr << "bouncer vel " << bouncer->vel << endl;
-//        cerr << "bouncer turn " << bouncer->angle << endl;
-//        cerr << "target pos " << target->pos << endl;
-//        cerr << "target vel " << target->vel << endl;
-//        cerr << "target turn " << target->angle << endl;
-//        cerr << "checkpoint pos " << race.checkpoints[targetCP] << endl;
-//    }
-    return score;
-}
-
-
-// Score used by the first 10th place bot (with annealing K at 0.02).
-template<int TURNS>
-float AnnealingBot<TURNS>::scoreBenchmark(const PodState* pods[], const PodState* podsPrev[], const PodState* enemyPods[], const PodState* enemyPodsPrev[]) {
-    const int totalCPs = race.totalCPCount();
-
-    if(pods[0]->passedCheckpoints == totalCPs) {
-        for(int i = 1; i <= TURNS; i++) {
-            if(ourSimHistory[0][i].passedCheckpoints == totalCPs) {
-                return minScore + i * 500;
-            }
-        }
-    }
-    if(enemyPods[0]->passedCheckpoints == totalCPs) {
-        for(int i = 0; i < TURNS; i++) {
-            if(enemySimHistory[0][i].passedCheckpoints == totalCPs) {
-                return maxScore  - i * 500;
-            }
-        }
-    }
-    if(pods[0]->turnsSinceCP >= WANDER_TIMEOUT && pods[1]->turnsSinceCP >= WANDER_TIMEOUT) {
-        return maxScore;
-    }
-    if(enemyPods[0]->turnsSinceCP >= WANDER_TIMEOUT && enemyPods[1]->turnsSinceCP >= WANDER_TIMEOUT) {
-        return minScore;
-    }
-
-    float racerScore = -Vector::dist(pods[0]->pos, race.checkpoints[pods[0]->nextCheckpoint]) + 20000 * (pods[0]->passedCheckpoints - podsPrev[0]->passedCheckpoints);
-    float chaserScore = 0;
-    const int WANDER_BUFFER = 7;
-    racerScore -= 0.85*(-Vector::dist(enemyPods[0]->pos, race.checkpoints[enemyPods[0]->nextCheckpoint]) + 10000 * (enemyPods[0]->passedCheckpoints - enemyPodsPrev[0]->passedCheckpoints));
-    if(pods[0]->turnsSinceCP > 65) {
-        chaserScore -=  Vector::dist(pods[0]->pos, pods[1]->pos);
-        chaserScore += Vector::dist(enemyPods[1]->pos, pods[0]->pos);
-    } else {
-        chaserScore += +0.6*(100*(M_PI/2 - abs(physics.angleBetween(race.checkpoints[enemyPods[0]->nextCheckpoint]-enemyPods[0]->pos, race.checkpoints[enemyPods[0]->nextCheckpoint]-pods[1]->pos)))
-                             - 0.4*Vector::dist(enemyPods[0]->pos, pods[1]->pos) - Vector::dist(race.checkpoints[enemyPods[0]->nextCheckpoint], pods[1]->pos));
-    }
-    return 100000-(racerScore + chaserScore);
-}
-
-template<int TURNS>
-void AnnealingBot<TURNS>::simulate(SimBot* pods1Sim, SimBot* pods2Sim, int turns, int startFromTurn) {
-    PodState* allPods[POD_COUNT*2];
-    for(int i = startFromTurn; i < turns; i++) {
-        memcpy(ourSimHistory[i+1], ourSimHistory[i], POD_COUNT*sizeof(PodState));
-        memcpy(enemySimHistory[i+1], enemySimHistory[i], POD_COUNT*sizeof(PodState));
-        allPods[0] = &ourSimHistory[i+1][0];
-        allPods[1] = &ourSimHistory[i+1][1];
-        allPods[2] = &enemySimHistory[i+1][0];
-        allPods[3] = &enemySimHistory[i+1][1];
-        pods1Sim->move(ourSimHistory[i+1], enemySimHistory[i]);
-        pods2Sim->move(enemySimHistory[i+1], ourSimHistory[i]);
-        physics.simulate(allPods);
-    }
-}
-#endif //CODERSSTRIKEBACKC_ANNEALINGBOT_H
\ No newline at end of file
+#endif //CODERSSTRIKEBACKC_ANNEALINGBOT_H
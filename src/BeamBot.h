@@ -0,0 +1,241 @@
+#ifndef CODERSSTRIKEBACK_BEAMBOT_H
+#define CODERSSTRIKEBACK_BEAMBOT_H
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "SearchBot.h"
+
+/**
+ * Beam search over a small set of per-pod actions, an alternative to AnnealingBot with the same rollouts and scoring.
+ *
+ * The search fixes one turn of the solution at a time. At depth d, every solution in the beam gets each pair of pod
+ * actions as its turn d; the turns after d stay as its parent had them (at first, last turn's solution shifted). The
+ * children are scored with score() resimulated from turn d, and the best of them with different pods after turn d
+ * (up to the beam width) go on to the next depth. Children that end up with near-identical pods (see StateKey) are
+ * taken for the same state, and only the best is kept, so that the beam isn't filled with copies of one line.
+ *
+ * The cost grows linearly with depth rather than the search space exponentially, so TURNS can be larger than
+ * annealing's for the same budget, at the price of a narrower beam.
+ */
+template<int TURNS>
+class BeamBot : public SearchBot<TURNS> {
+    using Base = SearchBot<TURNS>;
+    using Base::UNSET;
+    using Base::clockStart;
+    using Base::budget;
+    using Base::simCount;
+    using Base::previousSolution;
+    using Base::hasPrevious;
+    using Base::seeds;
+    using Base::seedCount;
+    using Base::ourSimHistory;
+    using Base::enemySimHistory;
+    using Base::getTimeMilli;
+
+public:
+    // Per pod: turn left, straight or right at half or full thrust, or shield.
+    static const int POD_ACTIONS = 7;
+    static const int PAIR_ACTIONS = POD_ACTIONS * POD_ACTIONS;
+    // Beam width used when the budget doesn't set it.
+    static const int DEFAULT_WIDTH = 16;
+
+private:
+    // Grid the pods are snapped to when looking for duplicate states.
+    static constexpr float positionGrid = 20;
+    static constexpr float velocityGrid = 5;
+    static const int timeBufferMilli = 1;
+
+    struct StateKey {
+        int cells[POD_COUNT][4];
+
+        bool operator==(const StateKey& other) const {
+            return memcmp(cells, other.cells, sizeof(cells)) == 0;
+        }
+    };
+
+    struct Entry {
+        PairOutput solution[TURNS];
+        // The rollout up to the entry's depth, to resimulate its children from.
+        PodState ourHistory[TURNS + 1][POD_COUNT];
+        PodState enemyHistory[TURNS + 1][POD_COUNT];
+    };
+
+    // A scored child, kept small since there are PAIR_ACTIONS of them for each entry in the beam.
+    struct Candidate {
+        int parent;
+        int action;
+        float score;
+        StateKey key;
+    };
+
+    vector<Entry> beam;
+    vector<Entry> nextBeam;
+    vector<Candidate> candidates;
+    vector<int> kept;
+    long long startTime;
+    int width = DEFAULT_WIDTH;
+    int depthReached = 0;
+
+    void init() {
+        startTime = clockStart == UNSET ? getTimeMilli() : clockStart;
+        clockStart = UNSET;
+        simCount = 0;
+        depthReached = 0;
+        // Each depth scores PAIR_ACTIONS children per entry, and then each kept one again for its rollout.
+        width = DEFAULT_WIDTH;
+        if(budget.kind == SearchBudget::ROLLOUTS) {
+            width = max<long>(1, this->rolloutBudget() / (TURNS * (PAIR_ACTIONS + 1)));
+        }
+    }
+
+    bool outOfTime() {
+        return budget.kind == SearchBudget::TIME && getTimeMilli() - startTime >= budget.amount - timeBufferMilli;
+    }
+
+    static PodOutputSim podAction(int action) {
+        if(action == POD_ACTIONS - 1) {
+            return PodOutputSim(0, 0, true, false);
+        }
+        return PodOutputSim((action / 3 + 1) * MAX_THRUST / 2, (action % 3 - 1) * MAX_ANGLE, false, false);
+    }
+
+    static PairOutput pairAction(int action) {
+        return PairOutput(podAction(action % POD_ACTIONS), podAction(action / POD_ACTIONS));
+    }
+
+    static int cell(float x, float grid) {
+        return (int) floor(x / grid);
+    }
+
+    StateKey keyAt(int turn) const {
+        StateKey key;
+        for(int p = 0; p < POD_COUNT; p++) {
+            const PodState& pod = ourSimHistory[turn][p];
+            key.cells[p][0] = cell(pod.pos.x, positionGrid);
+            key.cells[p][1] = cell(pod.pos.y, positionGrid);
+            key.cells[p][2] = cell(pod.vel.x, velocityGrid);
+            key.cells[p][3] = cell(pod.vel.y, velocityGrid);
+        }
+        return key;
+    }
+
+    void load(const Entry& entry, int depth) {
+        memcpy(ourSimHistory, entry.ourHistory, (depth + 1) * sizeof(ourSimHistory[0]));
+        memcpy(enemySimHistory, entry.enemyHistory, (depth + 1) * sizeof(enemySimHistory[0]));
+    }
+
+    void store(Entry& entry, int depth) {
+        memcpy(entry.ourHistory, ourSimHistory, (depth + 1) * sizeof(ourSimHistory[0]));
+        memcpy(entry.enemyHistory, enemySimHistory, (depth + 1) * sizeof(enemySimHistory[0]));
+    }
+
+    /**
+     * Score every child of the beam at the given depth. Returns false if time ran out part way.
+     */
+    bool expand(int depth) {
+        candidates.clear();
+        PairOutput solution[TURNS];
+        for(int b = 0; b < (int) beam.size(); b++) {
+            if(outOfTime()) return false;
+            memcpy(solution, beam[b].solution, sizeof(solution));
+            // The children of an entry only share the rollout up to depth, so these could all run side by side.
+            for(int a = 0; a < PAIR_ACTIONS; a++) {
+                load(beam[b], depth);
+                solution[depth] = pairAction(a);
+                float s = this->score(solution, depth);
+                simCount++;
+                candidates.push_back({b, a, s, keyAt(depth + 1)});
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Make the best distinct candidates the next beam, with their rollouts up to depth + 1.
+     */
+    void select(int depth) {
+        // Stable, as in GeneticBot::select().
+        stable_sort(candidates.begin(), candidates.end(),
+                    [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+        kept.clear();
+        for(int c = 0; c < (int) candidates.size() && (int) kept.size() < width; c++) {
+            bool duplicate = false;
+            for(int k : kept) {
+                if(candidates[k].key == candidates[c].key) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if(!duplicate) kept.push_back(c);
+        }
+        nextBeam.resize(kept.size());
+        for(int i = 0; i < (int) kept.size(); i++) {
+            const Candidate& c = candidates[kept[i]];
+            Entry& entry = nextBeam[i];
+            memcpy(entry.solution, beam[c.parent].solution, sizeof(entry.solution));
+            entry.solution[depth] = pairAction(c.action);
+            // Replayed rather than saved for every candidate: the rollouts are deterministic, and only a few are kept.
+            load(beam[c.parent], depth);
+            this->score(entry.solution, depth);
+            simCount++;
+            store(entry, depth + 1);
+        }
+        swap(beam, nextBeam);
+    }
+
+    void _train(const PodState podsToTrain[], const PodState opponentPods[], PairOutput solution[],
+                PodState* enemyPodState) {
+        this->setStart(podsToTrain, opponentPods);
+        beam.resize(1);
+        Entry& start = beam[0];
+        // The turns not yet searched: last turn's solution shifted by a turn, or straight on at full thrust.
+        for(int i = 0; i < TURNS; i++) {
+            start.solution[i] = hasPrevious && i < TURNS - 1 ? previousSolution[i + 1] :
+                                PairOutput(PodOutputSim(MAX_THRUST, 0, false, false),
+                                           PodOutputSim(MAX_THRUST, 0, false, false));
+        }
+        store(start, 0);
+        // Seeds start in the beam alongside it.
+        beam.resize(1 + seedCount);
+        for(int s = 0; s < seedCount; s++) {
+            beam[s + 1] = beam[0];
+            memcpy(beam[s + 1].solution, seeds[s], sizeof(beam[0].solution));
+        }
+        for(int depth = 0; depth < TURNS; depth++) {
+            bool finished = expand(depth);
+            if(!candidates.empty()) {
+                select(depth);
+                depthReached = depth + 1;
+            }
+            if(!finished) break;
+        }
+        cerr << "Sim count:" << simCount << " Beam width: " << width << " Depth: " << depthReached << endl;
+        memcpy(solution, beam[0].solution, TURNS * sizeof(PairOutput));
+        memcpy(previousSolution, solution, TURNS * sizeof(PairOutput));
+        // Replay the best solution for the opponent's states it leads to.
+        this->score(solution, 0);
+        memcpy(enemyPodState, enemySimHistory, TURNS * sizeof(PodState) * 2);
+        hasPrevious = true;
+    }
+
+public:
+    using Base::Base;
+
+    /**
+     * Solutions kept at each depth by the last search.
+     */
+    int beamWidth() const {
+        return width;
+    }
+
+    /**
+     * Turns fixed by the last search: TURNS, unless it ran out of time.
+     */
+    int searchDepth() const {
+        return depthReached;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_BEAMBOT_H
@@ -16,6 +16,14 @@ class SimBot {
 public:
     virtual void move(PodState ourPods[], PodState enemyPods[]) = 0;
     virtual void setTurn(int turn) {};
+
+    /**
+     * The opponent's pods (bit i for enemyPods[i]) that this bot looks at when moving the given one of its pods.
+     * Rollouts use it to tell when changing one pod's trajectory can't change the other side's moves. By default, both.
+     */
+    virtual int opponentPodsRead(int) const {
+        return 0x3;
+    }
 };
 
 
@@ -0,0 +1,174 @@
+#ifndef CODERSSTRIKEBACK_CMAES_H
+#define CODERSSTRIKEBACK_CMAES_H
+
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+/**
+ * Separable CMA-ES (Ros & Hansen, 2008): CMA-ES restricted to a diagonal covariance matrix, which keeps the update
+ * O(n) per sample and learns well with the few generations a full-game objective allows.
+ *
+ * The search runs in a space normalized to [0, 1] per dimension, so fields with very different scales (a checkpoint
+ * bonus in the thousands vs. a distance weight around 1) share one step size. Samples are clamped to the bounds.
+ *
+ * Usage is ask/tell: ask() for a population, evaluate it (in any order, in parallel), then tell() the costs.
+ * Lower cost is better.
+ */
+class SepCMAES {
+    int n;
+    int lambda;
+    int mu;
+    std::vector<double> weights;
+    double mueff;
+    double cc, cs, c1, cmu, damps, chiN;
+
+    std::vector<double> lower;
+    std::vector<double> upper;
+    // State, in normalized coordinates.
+    std::vector<double> xmean;
+    std::vector<double> diagC;
+    std::vector<double> pc;
+    std::vector<double> ps;
+    double stepSize;
+    int gen = 0;
+
+    std::mt19937 rng;
+    std::normal_distribution<double> normal;
+
+    double normalize(double x, int i) const {
+        return (x - lower[i]) / (upper[i] - lower[i]);
+    }
+
+    double denormalize(double x, int i) const {
+        return lower[i] + x * (upper[i] - lower[i]);
+    }
+
+public:
+    /**
+     * @param initialMean starting point, in the problem's own units.
+     * @param initialSigma step size as a fraction of each dimension's range. 0.3 is a sensible default.
+     * @param populationSize 0 chooses the standard 4 + 3ln(n).
+     */
+    SepCMAES(const std::vector<double>& initialMean, const std::vector<double>& lower, const std::vector<double>& upper,
+             double initialSigma, unsigned seed, int populationSize = 0) :
+            n(initialMean.size()), lower(lower), upper(upper), stepSize(initialSigma), rng(seed), normal(0.0, 1.0) {
+        lambda = populationSize > 0 ? populationSize : 4 + (int) (3 * std::log((double) n));
+        mu = lambda / 2;
+        double weightSum = 0;
+        for(int i = 0; i < mu; i++) {
+            weights.push_back(std::log(mu + 0.5) - std::log(i + 1.0));
+            weightSum += weights[i];
+        }
+        double weightSqSum = 0;
+        for(int i = 0; i < mu; i++) {
+            weights[i] /= weightSum;
+            weightSqSum += weights[i] * weights[i];
+        }
+        mueff = 1.0 / weightSqSum;
+
+        cc = 4.0 / (n + 4.0);
+        cs = (mueff + 2.0) / (n + mueff + 3.0);
+        c1 = 2.0 / ((n + 1.3) * (n + 1.3) + mueff);
+        cmu = std::min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((n + 2.0) * (n + 2.0) + mueff));
+        // The separable variant can afford faster covariance learning.
+        c1 *= (n + 2.0) / 3.0;
+        cmu = std::min(1.0 - c1, cmu * (n + 2.0) / 3.0);
+        damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (n + 1.0)) - 1.0) + cs;
+        chiN = std::sqrt((double) n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+        for(int i = 0; i < n; i++) {
+            xmean.push_back(std::min(1.0, std::max(0.0, normalize(initialMean[i], i))));
+        }
+        diagC.assign(n, 1.0);
+        pc.assign(n, 0.0);
+        ps.assign(n, 0.0);
+    }
+
+    int populationSize() const {
+        return lambda;
+    }
+
+    int generation() const {
+        return gen;
+    }
+
+    double sigma() const {
+        return stepSize;
+    }
+
+    std::vector<double> mean() const {
+        std::vector<double> m(n);
+        for(int i = 0; i < n; i++) {
+            m[i] = denormalize(xmean[i], i);
+        }
+        return m;
+    }
+
+    /**
+     * Sample a new population, in the problem's own units.
+     */
+    std::vector<std::vector<double>> ask() {
+        std::vector<std::vector<double>> population(lambda, std::vector<double>(n));
+        for(int k = 0; k < lambda; k++) {
+            for(int i = 0; i < n; i++) {
+                double step = std::sqrt(diagC[i]) * normal(rng);
+                double x = std::min(1.0, std::max(0.0, xmean[i] + stepSize * step));
+                population[k][i] = denormalize(x, i);
+            }
+        }
+        return population;
+    }
+
+    /**
+     * Update the distribution from the costs of the population returned by the last call to ask().
+     */
+    void tell(const std::vector<std::vector<double>>& population, const std::vector<double>& costs) {
+        std::vector<int> order(lambda);
+        for(int k = 0; k < lambda; k++) order[k] = k;
+        std::sort(order.begin(), order.end(), [&costs](int a, int b) { return costs[a] < costs[b]; });
+
+        // Recombination. Steps are recomputed from the clamped samples so the update sees what was evaluated.
+        std::vector<double> oldMean = xmean;
+        std::vector<std::vector<double>> selected(mu, std::vector<double>(n));
+        for(int i = 0; i < n; i++) {
+            double m = 0;
+            for(int j = 0; j < mu; j++) {
+                selected[j][i] = (normalize(population[order[j]][i], i) - oldMean[i]) / stepSize;
+                m += weights[j] * selected[j][i];
+            }
+            xmean[i] = oldMean[i] + stepSize * m;
+        }
+
+        // Evolution paths. With a diagonal C, C^(-1/2) is an element-wise division.
+        double psNormSq = 0;
+        for(int i = 0; i < n; i++) {
+            double meanStep = (xmean[i] - oldMean[i]) / stepSize;
+            ps[i] = (1 - cs) * ps[i] + std::sqrt(cs * (2 - cs) * mueff) * meanStep / std::sqrt(diagC[i]);
+            psNormSq += ps[i] * ps[i];
+        }
+        double psNorm = std::sqrt(psNormSq);
+        bool hsig = psNorm / std::sqrt(1 - std::pow(1 - cs, 2.0 * (gen + 1))) / chiN < 1.4 + 2.0 / (n + 1);
+        for(int i = 0; i < n; i++) {
+            double meanStep = (xmean[i] - oldMean[i]) / stepSize;
+            pc[i] = (1 - cc) * pc[i] + (hsig ? std::sqrt(cc * (2 - cc) * mueff) * meanStep : 0);
+        }
+
+        // Covariance: rank-one plus rank-mu update of the diagonal.
+        for(int i = 0; i < n; i++) {
+            double rankMu = 0;
+            for(int j = 0; j < mu; j++) {
+                rankMu += weights[j] * selected[j][i] * selected[j][i];
+            }
+            diagC[i] = (1 - c1 - cmu) * diagC[i] +
+                       c1 * (pc[i] * pc[i] + (hsig ? 0 : cc * (2 - cc) * diagC[i])) +
+                       cmu * rankMu;
+        }
+
+        stepSize *= std::exp((cs / damps) * (psNorm / chiN - 1));
+        gen++;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_CMAES_H
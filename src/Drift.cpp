@@ -0,0 +1,52 @@
+#include "Drift.h"
+#include "Physics.h"
+
+float Drift::powers[Drift::TABLE_TURNS + 1];
+float Drift::sums[Drift::TABLE_TURNS + 1];
+bool Drift::tablesReady = Drift::fillTables();
+
+bool Drift::fillTables() {
+    powers[0] = 1;
+    sums[0] = 0;
+    for(int k = 1; k <= TABLE_TURNS; k++) {
+        powers[k] = powers[k - 1] * DRAG;
+        sums[k] = sums[k - 1] + powers[k - 1];
+    }
+    return true;
+}
+
+int Drift::firstTurnWithin(const Vector& target, float radius, int maxTurns) const {
+    float radiusSq = radius * radius;
+    if(Vector::distSq(pos, target) <= radiusSq) return 0;
+    if(force.x == 0 && force.y == 0) {
+        float speedSq = vel.x * vel.x + vel.y * vel.y;
+        if(speedSq == 0) return -1;
+        // Along the line of travel, how far (in units of the starting speed) to the closest approach, and how far
+        // either side of it the pod is within radius.
+        Vector toTarget = target - pos;
+        float along = toTarget.dotProduct(vel) / speedSq;
+        float offSq = toTarget.getLengthSq() - along * along * speedSq;
+        if(offSq > radiusSq || along < 0) return -1;
+        float enter = along - std::sqrt((radiusSq - offSq) / speedSq);
+        // S(k) increases with k, so the first turn that reaches the circle is found by bisection.
+        int lo = 1;
+        int hi = maxTurns;
+        if(hi < lo || dragSum(hi) < enter) return -1;
+        while(lo < hi) {
+            int mid = (lo + hi) / 2;
+            if(dragSum(mid) >= enter) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+    Vector previous = pos;
+    for(int k = 1; k <= maxTurns; k++) {
+        Vector current = position(k);
+        if(Vector::distSq(current, target) <= radiusSq ||
+           Physics::passedPoint(previous, current, target, radius)) {
+            return k;
+        }
+        previous = current;
+    }
+    return -1;
+}
@@ -0,0 +1,79 @@
+#ifndef CODERSSTRIKEBACK_DRIFT_H
+#define CODERSSTRIKEBACK_DRIFT_H
+
+#include "State.h"
+#include "Vector.h"
+
+/**
+ * Closed-form motion of a pod that keeps the same thrust vector every turn (it is already facing where it thrusts,
+ * or is coasting), so that "where is it after k turns" doesn't need k calls to Physics::move.
+ *
+ * Each turn the game does v += F; p += v; v *= DRAG, which sums to
+ *     p(k) = p + v * S(k) + F * (k - DRAG * S(k)) / (1 - DRAG)
+ *     v(k) = v * DRAG^k + F * DRAG * S(k)
+ * with S(k) = 1 + DRAG + ... + DRAG^(k-1). The game also truncates positions and speeds to integers every turn,
+ * which this ignores: the speed comes out up to ~6 too high and the position a few units per turn too far, which
+ * is well inside the slack of the checkpoint, intercept and collision radii it is used with.
+ *
+ * The motion of one pod relative to another is also a Drift (of the differences), which is what collision
+ * prediction uses.
+ */
+class Drift {
+public:
+    // Turns covered by the drag tables. DRAG^64 is ~3e-5, so anything longer is as good as infinite.
+    static const int TABLE_TURNS = 64;
+
+private:
+    static float powers[TABLE_TURNS + 1];
+    static float sums[TABLE_TURNS + 1];
+    static bool tablesReady;
+    static bool fillTables();
+
+    Vector pos;
+    Vector vel;
+    Vector force;
+
+public:
+    Drift(const Vector& pos, const Vector& vel, const Vector& force) : pos(pos), vel(vel), force(force) {}
+
+    /**
+     * DRAG^k.
+     */
+    static float dragPower(int k) {
+        return k <= TABLE_TURNS ? powers[k] : std::pow(DRAG, k);
+    }
+
+    /**
+     * S(k) = 1 + DRAG + ... + DRAG^(k-1), the distance covered in k turns per unit of starting speed.
+     */
+    static float dragSum(int k) {
+        return k <= TABLE_TURNS ? sums[k] : (1 - std::pow(DRAG, k)) / (1 - DRAG);
+    }
+
+    /**
+     * Position after k turns.
+     */
+    Vector position(int k) const {
+        float s = dragSum(k);
+        float f = (k - DRAG * s) / (1 - DRAG);
+        return Vector(pos.x + vel.x * s + force.x * f, pos.y + vel.y * s + force.y * f);
+    }
+
+    /**
+     * Speed after k turns, after drag (as Physics::move leaves it).
+     */
+    Vector velocity(int k) const {
+        float p = dragPower(k);
+        float f = DRAG * dragSum(k);
+        return Vector(vel.x * p + force.x * f, vel.y * p + force.y * f);
+    }
+
+    /**
+     * The first turn k in [0, maxTurns] at which the pod is within radius of the target, or passes within radius
+     * of it during turn k. Returns -1 if that doesn't happen. A coasting pod moves along a straight line, and the
+     * turn is found by binary search over the drag sums; otherwise each turn is checked in O(1).
+     */
+    int firstTurnWithin(const Vector& target, float radius, int maxTurns) const;
+};
+
+#endif //CODERSSTRIKEBACK_DRIFT_H
@@ -0,0 +1,34 @@
+#ifndef CODERSSTRIKEBACK_EDITFILTER_H
+#define CODERSSTRIKEBACK_EDITFILTER_H
+
+#include "State.h"
+
+/**
+ * Decides which of the annealer's edits are worth a rollout (see AnnealingBot::editScreen and EditScreen).
+ */
+class EditFilter {
+public:
+    virtual ~EditFilter() {}
+
+    /**
+     * Start over for a new search.
+     */
+    virtual void reset() = 0;
+
+    /**
+     * Look at an edit of the given turn, from before to after, at progress (0 to 1) through the search.
+     */
+    virtual void describe(const PairOutput& before, const PairOutput& after, int turn, float progress) = 0;
+
+    /**
+     * Whether the edit described last should be rolled out. If not, it is to be rejected.
+     */
+    virtual bool shouldRollOut() = 0;
+
+    /**
+     * Learn from whether the edit described last, which was rolled out, was accepted.
+     */
+    virtual void learn(bool accepted) = 0;
+};
+
+#endif //CODERSSTRIKEBACK_EDITFILTER_H
@@ -0,0 +1,87 @@
+#include <cmath>
+#include <cstring>
+
+#include "EditScreen.h"
+
+EditScreen::Stats& EditScreen::Stats::operator+=(const Stats& other) {
+    proposals += other.proposals;
+    skipped += other.skipped;
+    audited += other.audited;
+    auditedRejected += other.auditedRejected;
+    missed += other.missed;
+    return *this;
+}
+
+double EditScreen::Stats::precision() const {
+    return audited == 0 ? 0 : (double) auditedRejected / audited;
+}
+
+double EditScreen::Stats::recall() const {
+    double caught = (skipped + audited) * precision();
+    return caught + missed == 0 ? 0 : caught / (caught + missed);
+}
+
+void EditScreen::reset() {
+    memset(weights, 0, sizeof(weights));
+    prediction = 1;
+    trained = 0;
+    sinceAudit = 0;
+    auditing = false;
+    counts = Stats();
+}
+
+void EditScreen::describe(const PairOutput& before, const PairOutput& after, int turn, float progress) {
+    memset(features, 0, sizeof(features));
+    features[0] = 1;
+    const PodOutputSim* from[] = {&before.o1, &before.o2};
+    const PodOutputSim* to[] = {&after.o1, &after.o2};
+    for(int p = 0; p < POD_COUNT; p++) {
+        if(from[p]->thrust != to[p]->thrust) {
+            features[1 + p] = 1;
+            features[7 + p] = abs(to[p]->thrust - from[p]->thrust) / (float) MAX_THRUST;
+        }
+        if(from[p]->angle != to[p]->angle) {
+            features[3 + p] = 1;
+            features[9 + p] = abs(to[p]->angle - from[p]->angle) / (2 * MAX_ANGLE);
+        }
+        if(from[p]->shieldEnabled != to[p]->shieldEnabled || from[p]->boostEnabled != to[p]->boostEnabled) {
+            features[5 + p] = 1;
+        }
+    }
+    features[11 + min(turn, TURN_BUCKETS - 1)] = 1;
+    features[FEATURES - 1] = progress;
+    float logit = 0;
+    for(int i = 0; i < FEATURES; i++) {
+        logit += weights[i] * features[i];
+    }
+    prediction = 1 / (1 + exp(-logit));
+}
+
+bool EditScreen::shouldRollOut() {
+    counts.proposals++;
+    auditing = false;
+    if(trained < warmup || prediction >= skipBelow) return true;
+    if(++sinceAudit >= auditPeriod) {
+        sinceAudit = 0;
+        auditing = true;
+        counts.audited++;
+        return true;
+    }
+    counts.skipped++;
+    return false;
+}
+
+void EditScreen::learn(bool accepted) {
+    if(!accepted) {
+        if(auditing) {
+            counts.auditedRejected++;
+        } else {
+            counts.missed++;
+        }
+    }
+    float error = (accepted ? 1 : 0) - prediction;
+    for(int i = 0; i < FEATURES; i++) {
+        weights[i] += learningRate * error * features[i];
+    }
+    trained++;
+}
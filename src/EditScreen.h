@@ -0,0 +1,85 @@
+#ifndef CODERSSTRIKEBACK_EDITSCREEN_H
+#define CODERSSTRIKEBACK_EDITSCREEN_H
+
+#include "State.h"
+#include "EditFilter.h"
+
+/**
+ * A pre-screen for the annealer's edits: an online logistic model of whether an edit will be accepted, over which
+ * control of which pod it changed, by how much, on which turn, and how far the search has cooled. It learns from every
+ * edit that is rolled out, and lets the search skip the rollout of an edit it is confident would be rejected.
+ * Acceptance itself stays exact: an edit is only ever kept on its rollout's score, a skipped one is simply rejected.
+ *
+ * Every auditPeriod-th edit the screen would skip is rolled out anyway, to keep the model learning where it skips and
+ * to measure it: how many of the edits it would skip really are rejected (precision), and how many of all rejected
+ * edits it skips (recall).
+ */
+class EditScreen : public EditFilter {
+public:
+    static const int TURN_BUCKETS = 8;
+    // Bias, what was edited for each pod (thrust, angle, shield or boost), the size of thrust and angle edits, the
+    // turn, and the search's progress.
+    static const int FEATURES = 1 + 6 + 4 + TURN_BUCKETS + 1;
+
+    struct Stats {
+        // Edits looked at.
+        long proposals = 0;
+        // Edits rejected without a rollout.
+        long skipped = 0;
+        // Edits the screen would have skipped, rolled out anyway, and how many of those were rejected.
+        long audited = 0;
+        long auditedRejected = 0;
+        // Edits the screen let through (or looked at before it was trained) that were rejected.
+        long missed = 0;
+
+        Stats& operator+=(const Stats& other);
+
+        /**
+         * The share of the edits the screen would skip that are rejected, as estimated from the audited ones.
+         */
+        double precision() const;
+
+        /**
+         * The share of rejected edits the screen skips, or would have skipped if not for the audits.
+         */
+        double recall() const;
+    };
+
+    // An edit is skipped if the chance that it is accepted is predicted to be below this.
+    float skipBelow = 0.02f;
+    int auditPeriod = 16;
+    // Edits learnt from before anything is skipped.
+    int warmup = 300;
+
+    EditScreen() {
+        reset();
+    }
+
+    /**
+     * Start over, e.g. for a new search: the model is forgotten, and so are the stats.
+     */
+    void reset();
+
+    void describe(const PairOutput& before, const PairOutput& after, int turn, float progress);
+
+    bool shouldRollOut();
+
+    void learn(bool accepted);
+
+    const Stats& stats() const {
+        return counts;
+    }
+
+private:
+    static constexpr float learningRate = 0.05f;
+    float weights[FEATURES];
+    float features[FEATURES];
+    // Predicted chance that the edit described last is accepted.
+    float prediction = 1;
+    long trained = 0;
+    int sinceAudit = 0;
+    bool auditing = false;
+    Stats counts;
+};
+
+#endif //CODERSSTRIKEBACK_EDITSCREEN_H
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+
+#include "EndgameSolver.h"
+#include "Drift.h"
+
+PodOutputSim EndgameSolver::control(int angle, int thrust) {
+    // Thrusts are full, half and none, then boost.
+    float turn = (angle - ANGLES / 2) * MAX_ANGLE / (ANGLES / 2);
+    if(thrust == THRUSTS) {
+        return PodOutputSim(MAX_THRUST, turn, false, true);
+    }
+    return PodOutputSim((THRUSTS - 1 - thrust) * MAX_THRUST / (THRUSTS - 1), turn, false, false);
+}
+
+bool EndgameSolver::step(PodState& pod, const PodOutputSim& control) const {
+    Physics::apply(pod, control);
+    return physics.simulateSolo(pod);
+}
+
+// Farthest a pod can be pushed, from where it would coast to, by k turns of the given thrust (or a boost, then the
+// thrust).
+static float thrustReach(int k, bool boost) {
+    float distance = MAX_THRUST * (k - DRAG * Drift::dragSum(k)) / (1 - DRAG);
+    if(boost) {
+        distance += (BOOST_ACC - MAX_THRUST) * Drift::dragSum(k);
+    }
+    return distance;
+}
+
+// Distance from the point to the segment from a to b.
+static float distToSegment(const Vector& point, const Vector& a, const Vector& b) {
+    Vector ab = b - a;
+    float lengthSq = ab.getLengthSq();
+    float t = lengthSq == 0 ? 0 : max(0.0f, min(1.0f, (point - a).dotProduct(ab) / lengthSq));
+    return Vector::dist(point, a + ab * t);
+}
+
+// Angle between two directions, in [0, pi].
+static float angleApart(float a, float b) {
+    float diff = abs(a - b);
+    return diff > M_PI ? 2 * M_PI - diff : diff;
+}
+
+// Farthest k turns of thrust can push a pod facing heading along a direction off its heading by offAngle. The pod
+// turns by at most MAX_ANGLE before each turn's thrust.
+static float thrustReachAlong(int k, float offAngle, bool boost) {
+    float distance = 0;
+    for(int i = 1; i <= k; i++) {
+        float off = offAngle - i * MAX_ANGLE;
+        if(off >= M_PI / 2) continue;
+        distance += MAX_THRUST * Drift::dragSum(k + 1 - i) * (off <= 0 ? 1 : cos(off));
+    }
+    if(boost) {
+        distance += (BOOST_ACC - MAX_THRUST) * Drift::dragSum(k);
+    }
+    return distance;
+}
+
+int EndgameSolver::lowerBound(const PodState& pod) const {
+    const Vector& target = race->checkpoints[pod.nextCheckpoint];
+    Vector before = pod.pos;
+    for(int k = 1; k <= MAX_TURNS; k++) {
+        // The pod is somewhere within reach of where it would coast to, before and after turn k, and so on the
+        // segment between those two discs. The truncation to integers is allowed a unit a turn each way.
+        Vector after = pod.pos + pod.vel * Drift::dragSum(k);
+        float gap = distToSegment(target, before, after) - CHECKPOINT_RADIUS - 2 * k;
+        if(gap <= thrustReach(k, pod.boostAvailable)) {
+            // Closer: the thrust towards the checkpoint is limited by how far the pod has to turn to face it, from
+            // the nearest of the directions from the segment to the checkpoint.
+            float toBefore = Physics::angleTo(before, target);
+            float toAfter = Physics::angleTo(after, target);
+            float off = min(angleApart(pod.angle, toBefore), angleApart(pod.angle, toAfter));
+            if(angleApart(pod.angle, toBefore) + angleApart(pod.angle, toAfter) <= angleApart(toBefore, toAfter) + 1e-4) {
+                off = 0;
+            }
+            if(gap <= thrustReachAlong(k, off, pod.boostAvailable)) {
+                return k;
+            }
+        }
+        before = after;
+    }
+    return MAX_TURNS + 1;
+}
+
+uint64_t EndgameSolver::snap(const PodState& pod) {
+    static const int POSITION_GRID = 10;
+    static const int VELOCITY_GRID = 4;
+    static const float ANGLE_GRID = M_PI / 90;
+    int64_t cells[] = {(int64_t) floor(pod.pos.x / POSITION_GRID), (int64_t) floor(pod.pos.y / POSITION_GRID),
+                       (int64_t) floor(pod.vel.x / VELOCITY_GRID), (int64_t) floor(pod.vel.y / VELOCITY_GRID),
+                       (int64_t) floor(pod.angle / ANGLE_GRID), pod.boostAvailable,
+                       min(pod.turnsSinceShield, SHIELD_COOLDOWN + 1)};
+    uint64_t key = 0;
+    for(int64_t cell : cells) {
+        key = key * 0x100000001b3ULL ^ (uint64_t) cell;
+    }
+    return key;
+}
+
+bool EndgameSolver::improves(uint64_t key, int depth) {
+    for(int i = 0; i < PROBES; i++) {
+        Slot& slot = reached[(key + i) & (TABLE_SIZE - 1)];
+        if(slot.round != round) {
+            slot = Slot{key, round, depth};
+            return true;
+        }
+        if(slot.key == key) {
+            if(slot.depth <= depth) return false;
+            slot.depth = depth;
+            return true;
+        }
+    }
+    return true;
+}
+
+void EndgameSolver::search(const PodState& pod, int depth) {
+    if(nodes >= nodeLimit || depth + lowerBound(pod) >= best) return;
+    // Turns nearest towards the checkpoint first, so that a plan is found early.
+    const Vector& target = race->checkpoints[pod.nextCheckpoint];
+    float wanted = Physics::turnAngle(pod, target - pod.vel * 3) * (ANGLES / 2) / MAX_ANGLE + ANGLES / 2;
+    int angles[ANGLES];
+    for(int a = 0; a < ANGLES; a++) {
+        int i = a;
+        for(; i > 0 && abs(angles[i - 1] - wanted) > abs(a - wanted); i--) {
+            angles[i] = angles[i - 1];
+        }
+        angles[i] = a;
+    }
+    int thrusts = pod.boostAvailable ? THRUSTS + 1 : THRUSTS;
+    for(int a = 0; a < ANGLES; a++) {
+        for(int t = 0; t < thrusts && nodes < nodeLimit; t++) {
+            PodOutputSim c = control(angles[a], t);
+            PodState child = pod;
+            step(child, c);
+            nodes++;
+            if(depth == 0) {
+                first = c;
+            }
+            path[depth + 1] = child.pos;
+            if(child.passedCheckpoints == race->totalCPCount()) {
+                best = depth + 1;
+                bestFirst = first;
+                copy(path, path + best + 1, bestPath);
+                return;
+            }
+            if(improves(snap(child), depth + 1)) {
+                search(child, depth + 1);
+                if(best <= depth + 1) return;
+            }
+        }
+    }
+}
+
+bool EndgameSolver::clear(const PodState others[], int count) const {
+    for(int o = 0; o < count; o++) {
+        const PodState& other = others[o];
+        Vector before = other.pos;
+        for(int k = 1; k <= best; k++) {
+            // The other pod is within reach of where it would coast to. Both move in straight lines during the
+            // turn, so the gap between the racer and that point does too.
+            Vector after = other.pos + other.vel * Drift::dragSum(k);
+            float gap = distToSegment(Vector(0, 0), bestPath[k - 1] - before, bestPath[k] - after);
+            if(gap - thrustReach(k, other.boostAvailable) - 2 * k < 2 * POD_RADIUS) {
+                return false;
+            }
+            before = after;
+        }
+    }
+    return true;
+}
+
+bool EndgameSolver::solve(const PodState& racer, const PodState others[], int otherCount, Plan& plan) {
+    nodes = 0;
+    path[0] = racer.pos;
+    // Iterative deepening: each round looks for a plan of at most limit turns, so the first one found is the fastest.
+    for(int limit = lowerBound(racer); limit <= MAX_TURNS && nodes < nodeLimit; limit++) {
+        best = limit + 1;
+        round++;
+        search(racer, 0);
+        if(best <= limit) {
+            plan.first = bestFirst;
+            plan.turns = best;
+            return clear(others, otherCount);
+        }
+    }
+    return false;
+}
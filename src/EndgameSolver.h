@@ -0,0 +1,125 @@
+#ifndef CODERSSTRIKEBACK_ENDGAMESOLVER_H
+#define CODERSSTRIKEBACK_ENDGAMESOLVER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "State.h"
+#include "Physics.h"
+
+/**
+ * Fastest way for a racer on its last checkpoint to pass it, when nobody can get in its way.
+ *
+ * Iterative deepening depth-first search over a discrete set of controls (five turn angles at no, half and full
+ * thrust, and boost while it's available). A branch is cut when its depth plus a lower bound on the turns still
+ * needed is over the round's limit. The bound (lowerBound()) has the pod coast, plus the most its thrust could carry
+ * it towards the checkpoint: each turn's thrust only counts as much as the pod could face the checkpoint by then,
+ * turning the full 18 degrees every turn from the nearest of the directions to the checkpoint along its coasting path.
+ * No pod turns faster or gets further from its thrust, so the bound never overestimates. States reached again at no
+ * lower depth, after snapping them to a grid, are dominated and cut too. The first plan found is the fastest over
+ * those controls, up to the snapping.
+ *
+ * The racer is simulated alone, so a plan is only returned if no other pod, thrusting (or boosting) any way it likes,
+ * can come within collision distance of the racer before it passes the checkpoint.
+ */
+class EndgameSolver {
+public:
+    // Longest plan searched for. Further out the bound is too loose to prune well, and annealing does as well.
+    static const int MAX_TURNS = 10;
+    // Search nodes (simulated turns) per solve, a few milliseconds.
+    static const int DEFAULT_NODE_LIMIT = 20000;
+
+    struct Plan {
+        PodOutputSim first;
+        // Turns until the checkpoint is passed.
+        int turns;
+    };
+
+private:
+    static const int ANGLES = 5;
+    static const int THRUSTS = 3;
+    static const int TABLE_SIZE = 1 << 16;
+    // Slots looked at for a key before giving up on it.
+    static const int PROBES = 8;
+
+    struct Slot {
+        uint64_t key;
+        int round;
+        int depth;
+    };
+
+    const Race* race = nullptr;
+    Physics physics;
+    int nodeLimit = DEFAULT_NODE_LIMIT;
+    int nodes = 0;
+    // Turns of the plan found in this round, or one more than the round's limit.
+    int best = 0;
+    int round = 0;
+    PodOutputSim bestFirst;
+    PodOutputSim first;
+    // Lowest depth each snapped state has been reached at this round, open addressed. Slots from earlier rounds are
+    // free.
+    vector<Slot> reached;
+    // The racer's position after each turn of the best plan.
+    Vector bestPath[MAX_TURNS + 1];
+    Vector path[MAX_TURNS + 1];
+
+    static PodOutputSim control(int angle, int thrust);
+
+    /**
+     * One turn of a pod that collides with nothing. Returns whether it passed its next checkpoint.
+     */
+    bool step(PodState& pod, const PodOutputSim& control) const;
+
+    /**
+     * No fewer than this many turns are needed to pass the checkpoint, or MAX_TURNS + 1 if it can't be done in
+     * MAX_TURNS.
+     */
+    int lowerBound(const PodState& pod) const;
+
+    static uint64_t snap(const PodState& pod);
+
+    /**
+     * Whether the state is new, or reached at a lower depth than before; it is then recorded at this depth. A state
+     * that doesn't fit in the table counts as new.
+     */
+    bool improves(uint64_t key, int depth);
+
+    void search(const PodState& pod, int depth);
+
+    /**
+     * Whether none of the other pods can touch the racer along the best plan.
+     */
+    bool clear(const PodState others[], int count) const;
+
+public:
+    EndgameSolver() {}
+
+    EndgameSolver(RaceRef race) : race(race.get()), physics(race), reached(TABLE_SIZE, Slot{0, -1, 0}) {}
+
+    void setNodeLimit(int limit) {
+        nodeLimit = limit;
+    }
+
+    /**
+     * Whether the racer is on its last checkpoint, where solve() applies.
+     */
+    bool applies(const PodState& racer) const {
+        return racer.passedCheckpoints == race->totalCPCount() - 1;
+    }
+
+    /**
+     * Search for the racer's fastest plan to the final checkpoint. Returns false if there's none within MAX_TURNS or
+     * the node limit, or if one of the others could get in its way.
+     */
+    bool solve(const PodState& racer, const PodState others[], int otherCount, Plan& plan);
+
+    /**
+     * Search nodes used by the last solve().
+     */
+    int nodeCount() const {
+        return nodes;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_ENDGAMESOLVER_H
@@ -0,0 +1,105 @@
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <unistd.h>
+
+#include "FastIO.h"
+
+long long FastInput::nowMilli() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool FastInput::fill() {
+    ssize_t n;
+    do {
+        n = ::read(fd, buffer, BUFFER_SIZE);
+    } while(n < 0 && errno == EINTR);
+    lastFillMilli = nowMilli();
+    pos = 0;
+    len = n > 0 ? n : 0;
+    return len > 0;
+}
+
+bool FastInput::eof() {
+    while(true) {
+        while(pos < len && (buffer[pos] == ' ' || buffer[pos] == '\n' || buffer[pos] == '\r' || buffer[pos] == '\t')) {
+            pos++;
+        }
+        if(pos < len) return false;
+        if(!fill()) return true;
+    }
+}
+
+void FastInput::beginTurn() {
+    if(eof()) {
+        turnArrivalMilli = nowMilli();
+        return;
+    }
+    turnArrivalMilli = lastFillMilli;
+}
+
+int FastInput::readInt() {
+    if(eof()) return 0;
+    bool negative = false;
+    if(buffer[pos] == '-') {
+        negative = true;
+        pos++;
+    }
+    int value = 0;
+    while(true) {
+        if(pos == len && !fill()) break;
+        char c = buffer[pos];
+        if(c < '0' || c > '9') break;
+        value = value * 10 + (c - '0');
+        pos++;
+    }
+    return negative ? -value : value;
+}
+
+void FastOutput::append(const char* s) {
+    while(*s) buffer[len++] = *s++;
+}
+
+void FastOutput::appendInt(int value) {
+    if(value < 0) {
+        buffer[len++] = '-';
+        value = -value;
+    }
+    char digits[12];
+    int n = 0;
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while(value > 0);
+    while(n > 0) buffer[len++] = digits[--n];
+}
+
+void FastOutput::write(const PodOutputAbs& output) {
+    // A line is at most 32 characters.
+    if(len > (int) sizeof(buffer) - 32) flush();
+    appendInt((int) round(output.target.x));
+    buffer[len++] = ' ';
+    appendInt((int) round(output.target.y));
+    buffer[len++] = ' ';
+    if(output.thrust == PodOutputAbs::BOOST) {
+        append("BOOST");
+    } else if(output.thrust == PodOutputAbs::SHIELD) {
+        append("SHIELD");
+    } else {
+        appendInt((int) round(output.thrust));
+    }
+    buffer[len++] = '\n';
+}
+
+void FastOutput::flush() {
+    int written = 0;
+    while(written < len) {
+        ssize_t n = ::write(fd, buffer + written, len - written);
+        if(n < 0) {
+            if(errno == EINTR) continue;
+            break;
+        }
+        written += n;
+    }
+    len = 0;
+}
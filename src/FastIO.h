@@ -0,0 +1,84 @@
+#ifndef CODERSSTRIKEBACK_FASTIO_H
+#define CODERSSTRIKEBACK_FASTIO_H
+
+#include "State.h"
+
+/**
+ * Reads whitespace separated integers straight from a file descriptor, without iostreams.
+ *
+ * It also remembers when input arrived, so the bot can start its clock from when a turn's input arrived rather than
+ * from when it got around to reading it.
+ */
+class FastInput {
+    static const int BUFFER_SIZE = 1 << 16;
+    int fd;
+    char buffer[BUFFER_SIZE];
+    int pos = 0;
+    int len = 0;
+    long long lastFillMilli = 0;
+    long long turnArrivalMilli = 0;
+
+    bool fill();
+
+public:
+    explicit FastInput(int fd = 0) : fd(fd) {}
+
+    FastInput(const FastInput&) = delete;
+    FastInput& operator=(const FastInput&) = delete;
+
+    /**
+     * Milliseconds on the clock used by the bots (see AnnealingBot::getTimeMilli).
+     */
+    static long long nowMilli();
+
+    /**
+     * Call before reading a turn. Blocks until the turn's first byte is available and records when it arrived.
+     */
+    void beginTurn();
+
+    /**
+     * When the current turn's first byte arrived. If it was already buffered, this is when it was read.
+     */
+    long long turnArrival() const {
+        return turnArrivalMilli;
+    }
+
+    /**
+     * Returns 0 at end of input.
+     */
+    int readInt();
+
+    bool eof();
+};
+
+/**
+ * Collects a turn's output lines and writes them with a single system call.
+ */
+class FastOutput {
+    int fd;
+    char buffer[256];
+    int len = 0;
+
+    void append(const char* s);
+    void appendInt(int value);
+
+public:
+    explicit FastOutput(int fd = 1) : fd(fd) {}
+
+    /**
+     * Adds a line in the format expected by the referee; the same as PodOutputAbs::toString.
+     */
+    void write(const PodOutputAbs& output);
+
+    void flush();
+
+    const char* data() const {
+        return buffer;
+    }
+
+    int size() const {
+        return len;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_FASTIO_H
@@ -0,0 +1,187 @@
+#ifndef CODERSSTRIKEBACK_GENETICBOT_H
+#define CODERSSTRIKEBACK_GENETICBOT_H
+
+#include <algorithm>
+#include <cstring>
+
+#include "SearchBot.h"
+
+/**
+ * Steady-state genetic search over a population of solutions, an alternative to AnnealingBot with the same rollouts
+ * and scoring.
+ *
+ * A solution's genes are its per-turn, per-pod controls. Each generation breeds a batch of children: two parents are
+ * picked by tournament, crossed over gene by gene, and mutated with randomEdit(). The batch is scored (see
+ * scoreBatch()), then children and parents compete for the places in the population (elitist: the best solution found
+ * is never lost).
+ *
+ * The batch's rollouts are independent, but they are not batched: scoreBatch() rolls them out one after the other,
+ * through the same rollout buffers as AnnealingBot, so a generation costs what as many annealing steps would.
+ */
+template<int TURNS>
+class GeneticBot : public SearchBot<TURNS> {
+    using Base = SearchBot<TURNS>;
+    using Base::UNSET;
+    using Base::clockStart;
+    using Base::budget;
+    using Base::simCount;
+    using Base::rng;
+    using Base::previousSolution;
+    using Base::hasPrevious;
+    using Base::seeds;
+    using Base::seedCount;
+    using Base::enemySimHistory;
+    using Base::randomEdit;
+    using Base::randomSolution;
+    using Base::getTimeMilli;
+
+    static const int POPULATION = 24;
+    static const int BATCH = 12;
+    // Size of the tournament that picks each parent.
+    static const int TOURNAMENT = 2;
+    static constexpr float crossoverRate = 0.8;
+    // Chance of each mutation after the first; a child always gets at least one.
+    static constexpr float extraMutationRate = 0.3;
+    // Used when no budget is given, about what AnnealingBot's default schedule scores.
+    static const int defaultRollouts = 22400;
+    static const int timeBufferMilli = 1;
+
+    // The population followed by the batch of children. After each generation the first POPULATION are the best,
+    // in order of score.
+    PairOutput pool[POPULATION + BATCH][TURNS];
+    float scores[POPULATION + BATCH];
+    int order[POPULATION + BATCH];
+    PairOutput sorted[POPULATION + BATCH][TURNS];
+    long long startTime;
+    int generation = 0;
+
+    void init() {
+        startTime = clockStart == UNSET ? getTimeMilli() : clockStart;
+        clockStart = UNSET;
+        simCount = 0;
+        generation = 0;
+    }
+
+    bool hasBudget() {
+        switch(budget.kind) {
+            case SearchBudget::TIME:
+                return getTimeMilli() - startTime < budget.amount - timeBufferMilli;
+            case SearchBudget::ROLLOUTS:
+                return simCount < this->rolloutBudget();
+            case SearchBudget::COOLING_STEPS:
+                // There are no temperatures; each step is a generation.
+                return generation < budget.amount;
+            default:
+                return simCount < defaultRollouts;
+        }
+    }
+
+    int tournament() {
+        int best = rng.nextInt(POPULATION);
+        for(int i = 1; i < TOURNAMENT; i++) {
+            int other = rng.nextInt(POPULATION);
+            if(scores[other] < scores[best]) best = other;
+        }
+        return best;
+    }
+
+    void breed(const PairOutput a[], const PairOutput b[], PairOutput child[]) {
+        if(rng.nextFloat() < crossoverRate) {
+            for(int t = 0; t < TURNS; t++) {
+                child[t].o1 = rng.nextInt(2) ? a[t].o1 : b[t].o1;
+                child[t].o2 = rng.nextInt(2) ? a[t].o2 : b[t].o2;
+            }
+        } else {
+            memcpy(child, a, TURNS * sizeof(PairOutput));
+        }
+        do {
+            randomEdit(child[rng.nextInt(TURNS)]);
+        } while(rng.nextFloat() < extraMutationRate);
+    }
+
+    /**
+     * Keep the best POPULATION of the population and the children, in order of score.
+     */
+    void select(int count) {
+        for(int i = 0; i < count; i++) {
+            order[i] = i;
+        }
+        // Stable, so that ties keep the older solution and the search doesn't depend on the sort's implementation.
+        stable_sort(order, order + count, [this](int a, int b) { return scores[a] < scores[b]; });
+        float sortedScores[POPULATION + BATCH];
+        int kept = min(count, (int) POPULATION);
+        for(int i = 0; i < kept; i++) {
+            memcpy(sorted[i], pool[order[i]], TURNS * sizeof(PairOutput));
+            sortedScores[i] = scores[order[i]];
+        }
+        memcpy(pool, sorted, kept * sizeof(pool[0]));
+        memcpy(scores, sortedScores, kept * sizeof(float));
+    }
+
+    /**
+     * Score whole solutions from the start set by setStart(), one rollout after another.
+     */
+    void scoreBatch(const PairOutput solutions[][TURNS], int count, float scores[]) {
+        for(int i = 0; i < count; i++) {
+            scores[i] = this->score(solutions[i], 0);
+            simCount++;
+        }
+    }
+
+    void _train(const PodState podsToTrain[], const PodState opponentPods[], PairOutput solution[],
+                PodState* enemyPodState) {
+        this->setStart(podsToTrain, opponentPods);
+        // Warm start: last turn's best solution shifted by a turn, and variations of it.
+        int seeded = 0;
+        if(hasPrevious) {
+            for(int i = 0; i < TURNS - 1; i++) {
+                pool[0][i] = previousSolution[i + 1];
+            }
+            pool[0][TURNS - 1] = this->random();
+            seeded = 1;
+            for(; seeded < POPULATION / 2; seeded++) {
+                memcpy(pool[seeded], pool[0], TURNS * sizeof(PairOutput));
+                randomEdit(pool[seeded][rng.nextInt(TURNS)]);
+            }
+        }
+        for(int s = 0; s < seedCount && seeded < POPULATION; s++) {
+            memcpy(pool[seeded++], seeds[s], TURNS * sizeof(PairOutput));
+        }
+        for(int i = seeded; i < POPULATION; i++) {
+            randomSolution(pool[i]);
+        }
+        scoreBatch(pool, POPULATION, scores);
+        select(POPULATION);
+        while(hasBudget()) {
+            int children = BATCH;
+            if(budget.kind == SearchBudget::ROLLOUTS) {
+                children = min<long>(BATCH, this->rolloutBudget() - simCount);
+            }
+            for(int c = 0; c < children; c++) {
+                breed(pool[tournament()], pool[tournament()], pool[POPULATION + c]);
+            }
+            scoreBatch(pool + POPULATION, children, scores + POPULATION);
+            select(POPULATION + children);
+            generation++;
+        }
+        cerr << "Sim count:" << simCount << " Generations: " << generation << endl;
+        memcpy(solution, pool[0], TURNS * sizeof(PairOutput));
+        memcpy(previousSolution, solution, TURNS * sizeof(PairOutput));
+        // Replay the best solution for the opponent's states it leads to.
+        this->score(solution, 0);
+        memcpy(enemyPodState, enemySimHistory, TURNS * sizeof(PodState) * 2);
+        hasPrevious = true;
+    }
+
+public:
+    using Base::Base;
+
+    /**
+     * Generations bred by the last search.
+     */
+    int generationCount() const {
+        return generation;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_GENETICBOT_H
@@ -9,12 +9,12 @@
 using namespace std;
 
 Race InputParser::init() {
-    int laps, checkpointCount;
-    stream >> laps >> checkpointCount;
+    int laps = next();
+    int checkpointCount = next();
     vector<Vector> checkpoints;
     for(int i = 0; i < checkpointCount; i++) {
-        int x, y;
-        stream >> x >> y;
+        int x = next();
+        int y = next();
         checkpoints.push_back(Vector(x, y));
     }
     return Race(laps, checkpoints);
@@ -24,8 +24,12 @@ void InputParser::parseTurn(PlayerState playerStates[]) {
     for (int i = 0; i < PLAYER_COUNT; i++) {
         PodState podStates[POD_COUNT];
         for (int p = 0; p < POD_COUNT; p++) {
-            int x, y, vx, vy, angle, nextCheckpoint;
-            stream >> x >> y >> vx >> vy >> angle >> nextCheckpoint;
+            int x = next();
+            int y = next();
+            int vx = next();
+            int vy = next();
+            int angle = next();
+            int nextCheckpoint = next();
             float angleRad = M_PI * (angle / 180.0);
             PodState pod(x, y, vx, vy, angleRad, nextCheckpoint);
             podStates[p] = pod;
@@ -2,12 +2,27 @@
 #define CODERSSTRIKEBACK_INPUTPARSER_H
 
 #include "State.h"
+#include "FastIO.h"
 
 class InputParser {
-    istream& stream;
+    istream* stream = nullptr;
+    FastInput* fastInput = nullptr;
+
+    int next() {
+        if(fastInput) return fastInput->readInt();
+        int value;
+        *stream >> value;
+        return value;
+    }
 
 public:
-    InputParser(istream& stream) : stream(stream) {};
+    InputParser(istream& stream) : stream(&stream) {};
+
+    /**
+     * Parse from a file descriptor instead of a stream; used by the game loop, where parsing is on the clock.
+     */
+    InputParser(FastInput& input) : fastInput(&input) {};
+
     Race init();
     void parseTurn(PlayerState playerStates[]);
 };
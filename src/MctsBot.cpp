@@ -0,0 +1,313 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "MctsBot.h"
+
+MctsBot::MctsBot(RaceRef race, SearchBudget budget, int arenaSize) :
+        race(race.get()), physics(race), budget(budget), nodes(arenaSize),
+        pending(arenaSize) {
+    measureCourse();
+    reset();
+}
+
+void MctsBot::measureCourse() {
+    const int count = race->checkpoints.size();
+    courseLength.assign(race->totalCPCount() + 1, 0);
+    for(int k = 0; k < race->totalCPCount(); k++) {
+        courseLength[k + 1] = courseLength[k] + Vector::dist(race->checkpoints[k % count],
+                                                             race->checkpoints[(k + 1) % count]);
+    }
+}
+
+void MctsBot::reset() {
+    root = NONE;
+    playedAction = NONE;
+    freeHead = NONE;
+    for(int i = (int) nodes.size() - 1; i >= 0; i--) {
+        nodes[i].nextSibling = freeHead;
+        freeHead = i;
+    }
+}
+
+void MctsBot::reset(RaceRef r) {
+    race = r.get();
+    physics = Physics(r);
+    measureCourse();
+    reset();
+}
+
+PodOutputSim MctsBot::output(const PodState& pod, int action) const {
+    if(action == RACE) {
+        return racingOutput(pod);
+    }
+    if(action == ACTIONS - 1) {
+        return PodOutputSim(0, 0, true, false);
+    }
+    return PodOutputSim(((action - 1) / 3 + 1) * MAX_THRUST / 2, ((action - 1) % 3 - 1) * MAX_ANGLE, false, false);
+}
+
+PodOutputSim MctsBot::racingOutput(const PodState& pod) const {
+    // Aim at the next checkpoint, less some of the drift, and thrust less the further we have to turn.
+    Vector target = race->checkpoints[pod.nextCheckpoint] - pod.vel * 3;
+    float turn = Vector::distSq(pod.pos, target) < 1 ? 0 : Physics::turnAngle(pod, target);
+    float thrust = abs(turn) < M_PI / 2 ? MAX_THRUST * cos(turn) : 0;
+    return PodOutputSim(thrust, turn, false, false);
+}
+
+int MctsBot::freeNodeCount() const {
+    int count = 0;
+    for(int n = freeHead; n != NONE; n = nodes[n].nextSibling) {
+        count++;
+    }
+    return count;
+}
+
+int MctsBot::allocate() {
+    // Free nodes are chained through nextSibling.
+    int n = freeHead;
+    if(n != NONE) {
+        freeHead = nodes[n].nextSibling;
+    }
+    return n;
+}
+
+void MctsBot::initNode(int n, const PodState pods[], int action) {
+    Node& node = nodes[n];
+    memcpy(node.pods, pods, sizeof(node.pods));
+    node.firstChild = NONE;
+    node.nextSibling = NONE;
+    node.action = action;
+    node.visits = 0;
+    memset(node.armVisits, 0, sizeof(node.armVisits));
+    memset(node.armValue, 0, sizeof(node.armValue));
+}
+
+void MctsBot::recycle(int keep) {
+    // Mark the kept subtree, then chain everything else into the free list.
+    markStamp++;
+    if(keep != NONE) {
+        int top = 0;
+        pending[top++] = keep;
+        while(top > 0) {
+            int n = pending[--top];
+            nodes[n].mark = markStamp;
+            for(int c = nodes[n].firstChild; c != NONE; c = nodes[c].nextSibling) {
+                pending[top++] = c;
+            }
+        }
+    }
+    freeHead = NONE;
+    for(int i = (int) nodes.size() - 1; i >= 0; i--) {
+        if(keep == NONE || nodes[i].mark != markStamp) {
+            nodes[i].nextSibling = freeHead;
+            freeHead = i;
+        }
+    }
+}
+
+int MctsBot::findChild(int parent, int action) {
+    for(int c = nodes[parent].firstChild; c != NONE; c = nodes[c].nextSibling) {
+        if(nodes[c].action == action) return c;
+    }
+    return NONE;
+}
+
+int MctsBot::selectArm(const Node& node, int pod) {
+    const uint32_t* visits = node.armVisits[pod];
+    const float* values = node.armValue[pod];
+    // Try every action once, in random order, before trusting the averages.
+    int untried = 0;
+    for(int a = 0; a < ACTIONS; a++) {
+        if(visits[a] == 0) untried++;
+    }
+    if(untried > 0) {
+        int pick = rng.nextInt(untried);
+        for(int a = 0; a < ACTIONS; a++) {
+            if(visits[a] == 0 && pick-- == 0) return a;
+        }
+    }
+    float logVisits = log((float) node.visits);
+    int best = 0;
+    float bestUcb = -1;
+    for(int a = 0; a < ACTIONS; a++) {
+        float ucb = values[a] / visits[a] + exploration * sqrt(logVisits / visits[a]);
+        if(ucb > bestUcb) {
+            bestUcb = ucb;
+            best = a;
+        }
+    }
+    return best;
+}
+
+void MctsBot::apply(PodState pods[], const int actions[]) {
+    for(int p = 0; p < POD_COUNT*2; p++) {
+        Physics::apply(pods[p], output(pods[p], actions[p]));
+    }
+}
+
+void MctsBot::simulate(PodState pods[]) {
+    PodState* all[POD_COUNT*2] = {&pods[0], &pods[1], &pods[2], &pods[3]};
+    physics.simulate(all);
+}
+
+bool MctsBot::isTerminal(const PodState pods[]) {
+    const int totalCPs = race->totalCPCount();
+    for(int p = 0; p < POD_COUNT*2; p++) {
+        if(pods[p].passedCheckpoints >= totalCPs) return true;
+    }
+    return (pods[0].turnsSinceCP >= WANDER_TIMEOUT && pods[1].turnsSinceCP >= WANDER_TIMEOUT) ||
+           (pods[2].turnsSinceCP >= WANDER_TIMEOUT && pods[3].turnsSinceCP >= WANDER_TIMEOUT);
+}
+
+float MctsBot::progress(const PodState& pod) {
+    // Distance along the course, so that passing a checkpoint doesn't make a jump.
+    int passed = min(pod.passedCheckpoints, race->totalCPCount() - 1);
+    return courseLength[passed + 1] - Vector::dist(pod.pos, race->checkpoints[pod.nextCheckpoint]);
+}
+
+float MctsBot::lead(const PodState pods[]) {
+    // Both pods count: with only the lead pod's progress, the other pod has nothing to play for and gets in the way.
+    return progress(pods[0]) + progress(pods[1]) - progress(pods[2]) - progress(pods[3]);
+}
+
+float MctsBot::evaluate(const PodState pods[]) {
+    const int totalCPs = race->totalCPCount();
+    if(pods[0].passedCheckpoints >= totalCPs || pods[1].passedCheckpoints >= totalCPs) return 1;
+    if(pods[2].passedCheckpoints >= totalCPs || pods[3].passedCheckpoints >= totalCPs) return 0;
+    if(pods[0].turnsSinceCP >= WANDER_TIMEOUT && pods[1].turnsSinceCP >= WANDER_TIMEOUT) return 0;
+    if(pods[2].turnsSinceCP >= WANDER_TIMEOUT && pods[3].turnsSinceCP >= WANDER_TIMEOUT) return 1;
+    return max(0.0f, min(1.0f, 0.5f + (lead(pods) - rootLead) / valueScale));
+}
+
+float MctsBot::rollout(PodState pods[], int turns) {
+    for(int t = 0; t < turns && !isTerminal(pods); t++) {
+        for(int p = 0; p < POD_COUNT*2; p++) {
+            Physics::apply(pods[p], racingOutput(pods[p]));
+        }
+        simulate(pods);
+    }
+    return evaluate(pods);
+}
+
+void MctsBot::iterate() {
+    PodState pods[POD_COUNT*2];
+    int node = root;
+    path[0] = root;
+    // Actions chosen, and how many of the nodes they led to are in the tree (the last may not fit in the arena).
+    int steps = 0;
+    int stored = 0;
+    while(steps < HORIZON && !isTerminal(nodes[node].pods)) {
+        int* actions = pathActions[steps];
+        for(int p = 0; p < POD_COUNT*2; p++) {
+            actions[p] = selectArm(nodes[node], p);
+        }
+        int action = jointAction(actions);
+        int child = findChild(node, action);
+        steps++;
+        if(child != NONE) {
+            node = child;
+            path[++stored] = child;
+            continue;
+        }
+        memcpy(pods, nodes[node].pods, sizeof(pods));
+        apply(pods, actions);
+        simulate(pods);
+        child = allocate();
+        if(child != NONE) {
+            initNode(child, pods, action);
+            nodes[child].nextSibling = nodes[node].firstChild;
+            nodes[node].firstChild = child;
+            path[++stored] = child;
+        } else {
+            fullIterations++;
+        }
+        break;
+    }
+    if(stored == steps) {
+        memcpy(pods, nodes[path[stored]].pods, sizeof(pods));
+    }
+    float value = rollout(pods, HORIZON - steps);
+    for(int d = 0; d <= stored; d++) {
+        nodes[path[d]].visits++;
+    }
+    for(int d = 0; d < steps; d++) {
+        Node& n = nodes[path[d]];
+        for(int p = 0; p < POD_COUNT*2; p++) {
+            int a = pathActions[d][p];
+            n.armVisits[p][a]++;
+            n.armValue[p][a] += p < POD_COUNT ? value : 1 - value;
+        }
+    }
+}
+
+void MctsBot::setRoot(GameState& gameState) {
+    PodState observed[POD_COUNT*2] = {gameState.ourState().pods[0], gameState.ourState().pods[1],
+                                      gameState.enemyState().pods[0], gameState.enemyState().pods[1]};
+    int next = NONE;
+    if(root != NONE && playedAction != NONE) {
+        // The opponent's real move isn't one of ours, so take the child of our move that predicted the pods best.
+        float bestError = reuseTolerance;
+        for(int c = nodes[root].firstChild; c != NONE; c = nodes[c].nextSibling) {
+            if(ourAction(nodes[c].action) != playedAction) continue;
+            float error = 0;
+            for(int p = 0; p < POD_COUNT*2; p++) {
+                error += Vector::dist(nodes[c].pods[p].pos, observed[p].pos);
+            }
+            if(error < bestError) {
+                bestError = error;
+                next = c;
+            }
+        }
+    }
+    recycle(next);
+    if(next == NONE) {
+        root = allocate();
+        initNode(root, observed, 0);
+    } else {
+        root = next;
+        memcpy(nodes[root].pods, observed, sizeof(observed));
+        nodes[root].nextSibling = NONE;
+    }
+    reusedVisits = nodes[root].visits;
+}
+
+bool MctsBot::hasBudget() {
+    switch(budget.kind) {
+        case SearchBudget::TIME:
+            // The clock is only read every few iterations.
+            return (iterations & 0x3f) != 0 || getTimeMilli() - startTime < budget.amount - timeBufferMilli;
+        case SearchBudget::ROLLOUTS:
+            return iterations < budget.amount;
+        default:
+            return iterations < DEFAULT_ITERATIONS;
+    }
+}
+
+long long MctsBot::getTimeMilli() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+PairOutput MctsBot::move(GameState& gameState) {
+    startTime = clockStart == UNSET ? getTimeMilli() : clockStart;
+    clockStart = UNSET;
+    setRoot(gameState);
+    rootLead = lead(nodes[root].pods);
+    iterations = 0;
+    fullIterations = 0;
+    while(hasBudget()) {
+        iterate();
+        iterations++;
+    }
+    // The most visited action of each of our pods.
+    const Node& r = nodes[root];
+    int best[POD_COUNT] = {0, 0};
+    for(int p = 0; p < POD_COUNT; p++) {
+        for(int a = 1; a < ACTIONS; a++) {
+            if(r.armVisits[p][a] > r.armVisits[p][best[p]]) best[p] = a;
+        }
+    }
+    playedAction = best[0] + ACTIONS * best[1];
+    cerr << "MCTS iterations: " << iterations << " reused: " << reusedVisits << endl;
+    return PairOutput(output(r.pods[0], best[0]), output(r.pods[1], best[1]));
+}
@@ -0,0 +1,195 @@
+#ifndef CODERSSTRIKEBACK_MCTSBOT_H
+#define CODERSSTRIKEBACK_MCTSBOT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "State.h"
+#include "Bot.h"
+#include "Physics.h"
+#include "Random.h"
+#include "SearchBudget.h"
+
+/**
+ * Decoupled-UCT Monte Carlo tree search over both players' moves at once, in place of annealing an opponent model
+ * and then our own moves against it.
+ *
+ * Each pod picks from a small set of actions. At every node, each of the four pods has its own bandit (UCB1) over
+ * its actions, and the four choices together pick the child. Pods of one player maximise the evaluation, the other
+ * player's pods minimise it. Below the tree, every pod races
+ * for its next checkpoint up to the horizon.
+ *
+ * Nodes live in an arena allocated on construction. After a move, the subtree reached by our move and the
+ * opponent's closest matching move becomes the next root, and the rest of the arena is recycled.
+ */
+class MctsBot : public DuelBot {
+public:
+    // Per pod: the rollout policy's move, turn left, straight or right at half or full thrust, or shield.
+    static const int ACTIONS = 8;
+    static const int RACE = 0;
+    // Turns looked ahead from the root, in the tree and then in the rollout.
+    static const int HORIZON = 6;
+    static const int DEFAULT_ARENA = 1 << 15;
+    // Used when no budget is given.
+    static const int DEFAULT_ITERATIONS = 20000;
+
+private:
+    static const int NONE = -1;
+    static const int UNSET = -1;
+    static constexpr float exploration = 1;
+    // Change in the progress lead (see evaluate()) between a loss and a win. It's linear in between: squashing it
+    // (e.g. with tanh) saturates on the swings collisions and checkpoints make, and the arms can't be told apart.
+    static constexpr float valueScale = 10000;
+    // Largest total distance, over the four pods, between a child's predicted pods and the ones observed for it to
+    // be reused as the next root.
+    static constexpr float reuseTolerance = 400;
+    static const int timeBufferMilli = 1;
+
+    struct Node {
+        PodState pods[POD_COUNT*2];
+        int firstChild;
+        int nextSibling;
+        // The four pods' actions that led here (see jointAction()).
+        uint16_t action;
+        int visits;
+        int mark;
+        uint32_t armVisits[POD_COUNT*2][ACTIONS];
+        float armValue[POD_COUNT*2][ACTIONS];
+    };
+
+    const Race* race = nullptr;
+    Physics physics;
+    Random rng;
+    SearchBudget budget;
+    long long startTime;
+    long long clockStart = UNSET;
+    // Course length up to each checkpoint to pass, the first at index 1.
+    vector<float> courseLength;
+    vector<Node> nodes;
+    // Nodes still to visit when walking a subtree.
+    vector<int> pending;
+    int freeHead = NONE;
+    int root = NONE;
+    // Our pods' part of the joint action played from the root, or NONE.
+    int playedAction = NONE;
+    int markStamp = 0;
+    float rootLead;
+    int iterations = 0;
+    // Iterations that found no free node to grow the tree with.
+    int fullIterations = 0;
+    int reusedVisits = 0;
+    // The nodes and the actions chosen on the current iteration's way down.
+    int path[HORIZON + 1];
+    int pathActions[HORIZON][POD_COUNT*2];
+
+    static int jointAction(const int actions[]) {
+        return actions[0] + ACTIONS * (actions[1] + ACTIONS * (actions[2] + ACTIONS * actions[3]));
+    }
+
+    static int ourAction(int joint) {
+        return joint % (ACTIONS * ACTIONS);
+    }
+
+    void measureCourse();
+
+    int allocate();
+
+    void initNode(int n, const PodState pods[], int action);
+
+    void recycle(int keep);
+
+    int findChild(int parent, int action);
+
+    int selectArm(const Node& node, int pod);
+
+    void apply(PodState pods[], const int actions[]);
+
+    void simulate(PodState pods[]);
+
+    bool isTerminal(const PodState pods[]);
+
+    float progress(const PodState& pod);
+
+    float lead(const PodState pods[]);
+
+    /**
+     * In [0, 1], from our side: how much our pods' progress along the course gained on theirs since the root.
+     */
+    float evaluate(const PodState pods[]);
+
+    float rollout(PodState pods[], int turns);
+
+    void iterate();
+
+    void setRoot(GameState& gameState);
+
+    bool hasBudget();
+
+    long long getTimeMilli();
+
+public:
+    MctsBot(RaceRef race, SearchBudget budget = SearchBudget(), int arenaSize = DEFAULT_ARENA);
+
+    PairOutput move(GameState& gameState);
+
+    /**
+     * The output of one of the pod actions.
+     */
+    PodOutputSim output(const PodState& pod, int action) const;
+
+    /**
+     * The rollout policy: head for the next checkpoint.
+     */
+    PodOutputSim racingOutput(const PodState& pod) const;
+
+    void seed(uint64_t s) {
+        rng.seed(s);
+    }
+
+    void setBudget(SearchBudget b) {
+        budget = b;
+    }
+
+    void startClockAt(long long milli) {
+        clockStart = milli;
+    }
+
+    /**
+     * Forget the tree, e.g. for a new game on the same race.
+     */
+    void reset();
+
+    void reset(RaceRef r);
+
+    /**
+     * Iterations run by the last search.
+     */
+    int rolloutCount() const {
+        return iterations;
+    }
+
+    /**
+     * Visits the last search started with, from the subtree kept from the move before.
+     */
+    int reusedRolloutCount() const {
+        return reusedVisits;
+    }
+
+    int arenaSize() const {
+        return nodes.size();
+    }
+
+    /**
+     * Nodes of the arena not in the tree.
+     */
+    int freeNodeCount() const;
+
+    /**
+     * Iterations of the last search that found the arena full, and so evaluated a leaf without adding it.
+     */
+    int fullArenaIterations() const {
+        return fullIterations;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_MCTSBOT_H
@@ -5,6 +5,7 @@
 #include "State.h"
 #include "Physics.h"
 #include "Navigation.h"
+#include "Drift.h"
 
 
 PodOutputAbs Navigation::seek(const PodState &pod, const Vector &target) {
@@ -65,9 +66,10 @@ PodOutputAbs Navigation::preemptSeek(const PodState &pod, Vector initialTarget,
         // Hardcoded heuristic buffers. Tighter for when we are going to switch to the next CP as the cost of error
         // is much greater. TODO: turn into parameters and search for optimal values.
         int buffer = i <= switchThreshold ? 50 : 200;
-        // Extrapolate the pod's position under conditions of no thrust.
-        int future_x = pod.pos.x + geometric_sum(pod.vel.x, DRAG, 1, i);
-        int future_y = pod.pos.y + geometric_sum(pod.vel.y, DRAG, 1, i);
+        // Extrapolate the pod's position under conditions of no thrust: vel * (DRAG + DRAG^2 + ... + DRAG^i).
+        float driftFactor = Drift::dragSum(i + 1) - 1;
+        int future_x = pod.pos.x + pod.vel.x * driftFactor;
+        int future_y = pod.pos.y + pod.vel.y * driftFactor;
         Vector future_pos(future_x, future_y);
         // If the future position is close enough to the target, break.
         if ((initialTarget - future_pos).getLength() < radius - buffer) {
@@ -89,8 +91,8 @@ PodOutputAbs Navigation::preemptSeek(const PodState &pod, Vector initialTarget,
 }
 
 PodOutputAbs Navigation::preemptSeek(const PodState &pod) {
-    Vector nextCP = race.checkpoints[(pod.nextCheckpoint + 1) % race.checkpoints.size()];
-    return preemptSeek(pod, race.checkpoints[pod.nextCheckpoint], CHECKPOINT_RADIUS, nextCP);
+    Vector nextCP = race->checkpoints[(pod.nextCheckpoint + 1) % race->checkpoints.size()];
+    return preemptSeek(pod, race->checkpoints[pod.nextCheckpoint], CHECKPOINT_RADIUS, nextCP);
 }
 
 PodOutputAbs Navigation::intercept(const PodState &pod, const PodState &enemy) {
@@ -98,14 +100,10 @@ PodOutputAbs Navigation::intercept(const PodState &pod, const PodState &enemy) {
 }
 
 
-float Navigation::geometric_sum(float a, float r, int r1, int r2) {
-    return (a * pow(r, r1) - a * pow(r, (r2 + 1))) / (1 - r);
-}
-
 // Binary search along the path between the enemy and its next checkpoint- search for a point where our bot
 // and the enemy bot will arrive at the same time.
 Vector Navigation::find_intercept(const PodState &pod, const PodState &enemy) {
-    Vector intercept_path = race.checkpoints[enemy.nextCheckpoint] - enemy.pos;
+    Vector intercept_path = race->checkpoints[enemy.nextCheckpoint] - enemy.pos;
     // TODO: hardcoded heuristic- convert to parameter and search for optimum.
     // The distance between two points on the path below which is acceptable to be considered the same 'area' or
     // place where the bots are likely to collide.
@@ -137,25 +135,41 @@ Vector Navigation::find_intercept(const PodState &pod, const PodState &enemy) {
     } else {
         // If there doesn't seem to be a place where the two bots will arrive at the same time, target the enemy bot's
         // next next checkpoint in preparation.
-        int enemyNextNextCP = (enemy.nextCheckpoint + 1) % race.checkpoints.size();
-        return race.checkpoints[enemyNextNextCP];
+        int enemyNextNextCP = (enemy.nextCheckpoint + 1) % race->checkpoints.size();
+        return race->checkpoints[enemyNextNextCP];
     }
 }
 
+// Whether seek's force points along the line to the target, within the given angle. Then the pod's velocity is along
+// that line too, and seeking keeps thrusting along it.
+static bool seekForceAimsAt(const PodState &pod, const PodOutputAbs &control, const Vector &target, float maxAngle) {
+    Vector force = control.target - pod.pos;
+    Vector toTarget = target - pod.pos;
+    float dot = force.dotProduct(toTarget);
+    return dot > 0 && abs(force.crossProduct(toTarget)) <= tan(maxAngle) * dot;
+}
+
 int Navigation::turnsUntilReached(const PodState &podInit, Vector target, float withinDist) {
     int maxTurns = 30;
+    if((target - podInit.pos).getLength() <= withinDist) return 0;
     PodState pod = podInit;
     PodState previous = podInit;
-    PodOutputAbs control;
+    PodOutputAbs control = turnSaturationAdjust(pod, seek(pod, target));
     int i = 0;
-    while ((target - pod.pos).getLength() > withinDist &&
-           !physics.passedPoint(previous.pos, pod.pos, target, withinDist)) {
-        control = turnSaturationAdjust(pod, seek(pod, target));
+    // Step, seeking afresh each turn, while the pod is still turning towards its force (the turn is limited to
+    // MAX_ANGLE a turn) or seeking is still steering it onto the line to the target. Once it faces a force along that
+    // line, seeking keeps thrusting along it and the rest is closed form.
+    while(!physics.facesForce(pod, control.target - pod.pos) || !seekForceAimsAt(pod, control, target, 0.02)) {
+        previous = pod;
         pod = physics.move(pod, control, 1);
         i++;
-        // Currently, a bit of a hack to guard agains poor circular seeking behaviour causing endless
-        // circling around the target and causing this method to timeout the bot.
-        if (i >= maxTurns) break;
+        if((target - pod.pos).getLength() <= withinDist || physics.passedPoint(previous.pos, pod.pos, target, withinDist)) {
+            return i;
+        }
+        if(i >= maxTurns) return maxTurns;
+        control = turnSaturationAdjust(pod, seek(pod, target));
     }
-    return i;
-}
\ No newline at end of file
+    Drift drift(pod.pos, pod.vel, Physics::constantForce(pod, control.target - pod.pos, control.thrust));
+    int turns = drift.firstTurnWithin(target, withinDist, maxTurns - i);
+    return turns == -1 ? maxTurns : turns + i;
+}
@@ -5,15 +5,12 @@
 #include "Physics.h"
 
 class Navigation {
-    Race race;
+    const Race* race = nullptr;
     Physics physics;
-
-    // Si = ar^0 + ar^1 + ar^2...ar^i
-    float geometric_sum(float a, float r, int r1, int r2);
 public:
     Navigation() {}
 
-    Navigation(const Race &race) : race(race), physics(race) {}
+    Navigation(RaceRef race) : race(race.get()), physics(race) {}
 
     Vector find_intercept(const PodState &pod, const PodState &enemy);
 
@@ -30,6 +27,12 @@ public:
     PodOutputAbs preemptSeek(const PodState &pod, Vector initialTarget, float radius, Vector nextTarget,
                           int turnThreshold, int switchThreshold);
 
+    /**
+     * Turns for a pod seeking the target to come within the given distance of it, capped at 30. The turns
+     * in which the pod is still turning, or being steered onto the line to the target, are simulated; the rest is
+     * predicted with Drift, holding the thrust. Seeking eases off its thrust as the pod nears the target, which the
+     * closed form doesn't model, so the answer can be a turn earlier than stepping seek all the way.
+     */
     int turnsUntilReached(const PodState &podInit, Vector target, float withinDist);
 };
 
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "OpeningBook.h"
+#include "Physics.h"
+
+static const char BOOK_MAGIC[4] = {'C', 'S', 'B', 'O'};
+
+static bool keyLess(const OpeningBook::Entry& a, const OpeningBook::Entry& b) {
+    return a.key < b.key;
+}
+
+OpeningBook::OpeningBook(const Entry table[], int count) : entries(table, table + count) {
+    sort(entries.begin(), entries.end(), keyLess);
+}
+
+uint64_t OpeningBook::layoutKey(const Race& race, const PodState pods[]) {
+    // The positions as the game input gives them, FNV-1a hashed like the layout id.
+    uint32_t h = 2166136261u;
+    for(int p = 0; p < POD_COUNT; p++) {
+        int32_t coords[] = {(int32_t) lround(pods[p].pos.x), (int32_t) lround(pods[p].pos.y)};
+        for(int32_t v : coords) {
+            for(int b = 0; b < 4; b++) {
+                h ^= (v >> (8 * b)) & 0xff;
+                h *= 16777619u;
+            }
+        }
+    }
+    return (uint64_t) race.id << 32 | h;
+}
+
+OpeningBook::Action OpeningBook::pack(const PodOutputSim& output) {
+    Action action;
+    action.angle = (int16_t) lround(Physics::radToDegrees(output.angle) * 100);
+    action.thrust = (uint8_t) output.thrust;
+    action.flags = (output.shieldEnabled ? Action::SHIELD : 0) | (output.boostEnabled ? Action::BOOST : 0);
+    return action;
+}
+
+PodOutputSim OpeningBook::unpack(const Action& action) {
+    return PodOutputSim(action.thrust, Physics::degreesToRad(action.angle / 100.0f),
+                        (action.flags & Action::SHIELD) != 0, (action.flags & Action::BOOST) != 0);
+}
+
+void OpeningBook::add(uint64_t key, const PairOutput plan[]) {
+    Entry entry;
+    entry.key = key;
+    for(int t = 0; t < PLAN_TURNS; t++) {
+        entry.actions[t][0] = pack(plan[t].o1);
+        entry.actions[t][1] = pack(plan[t].o2);
+    }
+    auto it = lower_bound(entries.begin(), entries.end(), entry, keyLess);
+    if(it != entries.end() && it->key == key) {
+        *it = entry;
+    } else {
+        entries.insert(it, entry);
+    }
+}
+
+bool OpeningBook::lookup(const Race& race, const PodState pods[], PairOutput plan[]) const {
+    Entry probe;
+    probe.key = layoutKey(race, pods);
+    auto it = lower_bound(entries.begin(), entries.end(), probe, keyLess);
+    bool found = it != entries.end() && it->key == probe.key;
+    for(int t = 0; t < PLAN_TURNS; t++) {
+        if(found) {
+            plan[t] = PairOutput(unpack(it->actions[t][0]), unpack(it->actions[t][1]));
+        } else {
+            plan[t] = PairOutput(PodOutputSim(MAX_THRUST, 0, false, false), PodOutputSim(MAX_THRUST, 0, false, false));
+        }
+    }
+    return found;
+}
+
+bool OpeningBook::load(const string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if(!f) return false;
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    bool ok = fread(magic, sizeof(magic), 1, f) == 1 && memcmp(magic, BOOK_MAGIC, sizeof(magic)) == 0 &&
+              fread(&version, sizeof(version), 1, f) == 1 && version == VERSION &&
+              fread(&count, sizeof(count), 1, f) == 1;
+    vector<Entry> loaded(ok ? count : 0);
+    ok = ok && (count == 0 || fread(loaded.data(), sizeof(Entry), count, f) == count);
+    fclose(f);
+    if(!ok || !is_sorted(loaded.begin(), loaded.end(), keyLess)) return false;
+    entries.swap(loaded);
+    return true;
+}
+
+bool OpeningBook::save(const string& path) const {
+    FILE* f = fopen(path.c_str(), "wb");
+    if(!f) return false;
+    uint32_t version = VERSION;
+    uint32_t count = entries.size();
+    bool ok = fwrite(BOOK_MAGIC, sizeof(BOOK_MAGIC), 1, f) == 1 &&
+              fwrite(&version, sizeof(version), 1, f) == 1 &&
+              fwrite(&count, sizeof(count), 1, f) == 1 &&
+              (count == 0 || fwrite(entries.data(), sizeof(Entry), count, f) == count);
+    return fclose(f) == 0 && ok;
+}
+
+bool OpeningBook::saveHeader(const string& path, size_t maxBytes) const {
+    string text = "#ifndef CODERSSTRIKEBACK_OPENINGBOOKDATA_H\n"
+                  "#define CODERSSTRIKEBACK_OPENINGBOOKDATA_H\n\n"
+                  "#include \"OpeningBook.h\"\n\n"
+                  "// Generated by openingBook (see openingBookMain.cpp).\n"
+                  "static const int OPENING_BOOK_SIZE = " + to_string(entries.size()) + ";\n"
+                  "static const OpeningBook::Entry OPENING_BOOK[OPENING_BOOK_SIZE + 1] = {\n";
+    char buffer[32];
+    for(const Entry& entry : entries) {
+        snprintf(buffer, sizeof(buffer), "0x%016llxULL", (unsigned long long) entry.key);
+        text += string("{") + buffer + ",{";
+        for(int t = 0; t < PLAN_TURNS; t++) {
+            text += t > 0 ? ",{" : "{";
+            for(int p = 0; p < POD_COUNT; p++) {
+                const Action& a = entry.actions[t][p];
+                snprintf(buffer, sizeof(buffer), "%s{%d,%d,%d}", p > 0 ? "," : "", a.angle, a.thrust, a.flags);
+                text += buffer;
+            }
+            text += "}";
+        }
+        text += "}},\n";
+    }
+    text += "};\n\n#endif //CODERSSTRIKEBACK_OPENINGBOOKDATA_H\n";
+    if(text.size() > maxBytes) return false;
+    FILE* f = fopen(path.c_str(), "w");
+    if(!f) return false;
+    bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    return fclose(f) == 0 && ok;
+}
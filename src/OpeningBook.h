@@ -0,0 +1,88 @@
+#ifndef CODERSSTRIKEBACK_OPENINGBOOK_H
+#define CODERSSTRIKEBACK_OPENINGBOOK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "State.h"
+
+/**
+ * Opening plans searched offline, far deeper than a turn's budget allows, to seed the first searches of a game (see
+ * SearchBot::addSeed()).
+ *
+ * A plan is looked up by the race layout and the player's start positions (see layoutKey()), so each race has one
+ * plan per side of the start grid. Races not in the book get the generic plan: straight on at full thrust, which is
+ * where the pods face at the start.
+ *
+ * File layout: "CSBO", uint32 version, uint32 count, then count Entries sorted by key. The same entries can be
+ * compiled in as a table (see saveHeader()), for the single-file bot that can't read files.
+ */
+class OpeningBook {
+public:
+    static const uint32_t VERSION = 1;
+    // Turns of each plan.
+    static const int PLAN_TURNS = 6;
+
+    struct Action {
+        // Hundredths of a degree.
+        int16_t angle;
+        uint8_t thrust;
+        uint8_t flags;
+
+        static const uint8_t SHIELD = 1;
+        static const uint8_t BOOST = 2;
+    };
+
+    struct Entry {
+        uint64_t key;
+        // Pods in input order.
+        Action actions[PLAN_TURNS][POD_COUNT];
+    };
+
+private:
+    vector<Entry> entries;
+
+public:
+    OpeningBook() {}
+
+    /**
+     * A book over a compiled-in table, e.g. OPENING_BOOK from OpeningBookData.h.
+     */
+    OpeningBook(const Entry table[], int count);
+
+    /**
+     * Identifies the race layout and the start positions of a player's pods, in input order.
+     */
+    static uint64_t layoutKey(const Race& race, const PodState pods[]);
+
+    static Action pack(const PodOutputSim& output);
+
+    static PodOutputSim unpack(const Action& action);
+
+    /**
+     * Add a plan, or replace the one with the same key.
+     */
+    void add(uint64_t key, const PairOutput plan[]);
+
+    /**
+     * The book's plan for the player's pods, or the generic plan if there's none. Returns whether it was in the book.
+     */
+    bool lookup(const Race& race, const PodState pods[], PairOutput plan[]) const;
+
+    bool load(const string& path);
+
+    bool save(const string& path) const;
+
+    /**
+     * Write the entries as a C++ header defining OPENING_BOOK and OPENING_BOOK_SIZE. Returns false, writing nothing,
+     * if it would take more than maxBytes: the merged bot has to stay under the game's source size limit.
+     */
+    bool saveHeader(const string& path, size_t maxBytes) const;
+
+    int size() const {
+        return entries.size();
+    }
+};
+
+#endif //CODERSSTRIKEBACK_OPENINGBOOK_H
@@ -0,0 +1,10 @@
+#ifndef CODERSSTRIKEBACK_OPENINGBOOKDATA_H
+#define CODERSSTRIKEBACK_OPENINGBOOKDATA_H
+
+#include "OpeningBook.h"
+
+// Generated by openingBook (see openingBookMain.cpp). Empty: every race gets the generic plan.
+static const int OPENING_BOOK_SIZE = 0;
+static const OpeningBook::Entry OPENING_BOOK[OPENING_BOOK_SIZE + 1] = {};
+
+#endif //CODERSSTRIKEBACK_OPENINGBOOKDATA_H
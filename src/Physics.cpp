@@ -6,6 +6,8 @@
 
 #include "State.h"
 #include "Physics.h"
+#include "Drift.h"
+#include "ProfileScope.h"
 
 void Physics::apply(PodState& pod, PodOutputSim control) {
     if(abs(control.angle) > MAX_ANGLE) {
@@ -56,7 +58,7 @@ void Physics::apply(PodState& pod, const PodOutputAbs& control) {
     apply(pod, po);
 }
 
-bool PassedCheckpoint::testForPassedCheckpoint(PodState& a, Race& race, PassedCheckpoint* event, bool isEnemy) {
+bool PassedCheckpoint::testForPassedCheckpoint(PodState& a, const Race& race, PassedCheckpoint* event, bool isEnemy) {
     float CP_BUFFER = isEnemy ? 0 : -15;
     float time = Physics::passedCircleAt(a.pos.x, a.pos.y, a.pos.x + a.vel.x, a.pos.y + a.vel.y,
                  race.checkpoints[a.nextCheckpoint].x, race.checkpoints[a.nextCheckpoint].y, CHECKPOINT_RADIUS + CP_BUFFER);
@@ -74,6 +76,30 @@ void PassedCheckpoint::resolve() {
 }
 
 void Physics::simulate(PodState* pods[POD_COUNT*2]) {
+    int noneCulled = 0;
+    simulate(pods, noneCulled);
+}
+
+bool Physics::simulateSolo(PodState& pod) const {
+    // As simulate() does it, for a pod that collides with nothing.
+    pod.turnsSinceCP++;
+    pod.turnsSinceShield++;
+    PassedCheckpoint cpEvent;
+    bool passed = PassedCheckpoint::testForPassedCheckpoint(pod, *race, &cpEvent, false) && cpEvent.time() < 1.0;
+    if(passed) {
+        cpEvent.resolve();
+    }
+    pod.pos.x = (int) (pod.pos.x + pod.vel.x);
+    pod.pos.y = (int) (pod.pos.y + pod.vel.y);
+    pod.vel.x = (int) (pod.vel.x * DRAG);
+    pod.vel.y = (int) (pod.vel.y * DRAG);
+    pod.pos.resetLengths();
+    pod.vel.resetLengths();
+    return passed;
+}
+
+void Physics::simulate(PodState* pods[POD_COUNT*2], int& culledPairs, TurnLog* log) {
+    PROFILE_SCOPE(SIMULATE);
     // Update counters.
     for(int i = 0; i < POD_COUNT*2; i++) {
         pods[i]->turnsSinceCP++;
@@ -89,7 +115,21 @@ void Physics::simulate(PodState* pods[POD_COUNT*2]) {
     bool hasCollision = false;
     bool occurred = false;
     Collision collision;
+    if(log) {
+        log->substeps = 0;
+        log->collided = 0;
+    }
     while(time < 1) {
+        PROFILE_COUNT(SUBSTEP);
+        if(log && log->substeps != -1) {
+            if(log->substeps == TurnLog::MAX_SUBSTEPS) {
+                log->substeps = -1;
+            } else {
+                for(int i = 0; i < POD_COUNT*2; i++) {
+                    log->pods[log->substeps][i] = {pods[i]->pos.x, pods[i]->pos.y, pods[i]->vel.x, pods[i]->vel.y};
+                }
+            }
+        }
         for (int i = 0; i < POD_COUNT*2; i++) {
             // Collision or checkpoint passing first?
             for (int j = i + 1; j < POD_COUNT*2; j++) {
@@ -97,6 +137,10 @@ void Physics::simulate(PodState* pods[POD_COUNT*2]) {
                 if (skip[0] == i && skip[1] == j) {
                     continue;
                 }
+                if ((culledPairs & pairBit(i, j)) || !canMeet(*pods[i], *pods[j], 1 - time)) {
+                    continue;
+                }
+                PROFILE_COUNT(COLLISION_TEST);
                 // These two had the previous collision.
                 occurred = Collision::testForCollision(*pods[i], *pods[j], &collision);
                 // TODO: can the second zero time collision be ignored?
@@ -110,7 +154,8 @@ void Physics::simulate(PodState* pods[POD_COUNT*2]) {
                 }
             }
             // Can optimize by keeping list of pc events and resolving all those before the earliest collision.
-            occurred = PassedCheckpoint::testForPassedCheckpoint(*pods[i], race, &cpEvent, 1 > 1);
+            PROFILE_COUNT(CHECKPOINT_TEST);
+            occurred = PassedCheckpoint::testForPassedCheckpoint(*pods[i], *race, &cpEvent, 1 > 1);
             if (occurred && cpEvent.time() + time < 1.0) {
                 pCPEvents.push_back(cpEvent);
             }
@@ -122,12 +167,21 @@ void Physics::simulate(PodState* pods[POD_COUNT*2]) {
         }
         pCPEvents.clear();
         float moveTime = hasCollision ? earliest.time() : 1.0 - time;
+        if(log && log->substeps != -1) {
+            log->moveTime[log->substeps] = moveTime;
+            log->endsInCollision[log->substeps] = hasCollision;
+            log->substeps++;
+        }
         for(int i = 0; i < POD_COUNT*2; i++) {
             pods[i]->pos.x += pods[i]->vel.x * moveTime;
             pods[i]->pos.y += pods[i]->vel.y * moveTime;
         }
         if (hasCollision) {
+            PROFILE_COUNT(COLLISION);
             earliest.resolve();
+            if(log) log->collided |= (1 << earliestIdx[0]) | (1 << earliestIdx[1]);
+            // The pods' new speeds aren't covered by the horizon bounds.
+            culledPairs &= ~(podPairs(earliestIdx[0]) | podPairs(earliestIdx[1]));
             hasCollision = false;
             skip[0] = earliestIdx[0];
             skip[1] = earliestIdx[1];
@@ -149,6 +203,95 @@ void Physics::simulate(PodState* pods[POD_COUNT*2]) {
     }
 }
 
+bool Physics::simulateAlone(PodState& pod, int podIdx, TurnLog& log) {
+    PROFILE_COUNT(SIMULATE_ALONE);
+    if(log.substeps == -1 || (log.collided & (1 << podIdx))) return false;
+    // Mirrors simulate() for a pod that collides with nothing, with the turn split at the same times.
+    pod.turnsSinceCP++;
+    pod.turnsSinceShield++;
+    float time = 0;
+    PassedCheckpoint cpEvent;
+    Collision collision;
+    PodState other;
+    for(int k = 0; k < log.substeps; k++) {
+        float moveTime = log.moveTime[k];
+        for(int j = 0; j < POD_COUNT*2; j++) {
+            if(j == podIdx) continue;
+            const TurnLog::Motion& m = log.pods[k][j];
+            other.pos = Vector(m.x, m.y);
+            other.vel = Vector(m.vx, m.vy);
+            if(!canMeet(pod, other, 1 - time)) continue;
+            PROFILE_COUNT(COLLISION_TEST);
+            // simulate() tests each pair with the lower index first.
+            bool occurred = j < podIdx ? Collision::testForCollision(other, pod, &collision) :
+                                         Collision::testForCollision(pod, other, &collision);
+            // A collision no later than the one that ended the substep would have changed the turn.
+            if(occurred && collision.time() + time < 1.0 &&
+               (!log.endsInCollision[k] || collision.time() <= moveTime)) {
+                return false;
+            }
+        }
+        log.pods[k][podIdx] = {pod.pos.x, pod.pos.y, pod.vel.x, pod.vel.y};
+        PROFILE_COUNT(CHECKPOINT_TEST);
+        if(PassedCheckpoint::testForPassedCheckpoint(pod, *race, &cpEvent, false) && cpEvent.time() + time < 1.0 &&
+           (!log.endsInCollision[k] || cpEvent.time() < moveTime)) {
+            cpEvent.resolve();
+        }
+        pod.pos.x += pod.vel.x * moveTime;
+        pod.pos.y += pod.vel.y * moveTime;
+        time += moveTime;
+    }
+    pod.vel.x *= DRAG;
+    pod.vel.y *= DRAG;
+    pod.vel.x = (int) pod.vel.x;
+    pod.vel.y = (int) pod.vel.y;
+    pod.pos.x = (int) pod.pos.x;
+    pod.pos.y = (int) pod.pos.y;
+    pod.pos.resetLengths();
+    pod.vel.resetLengths();
+    return true;
+}
+
+bool Physics::canMeet(const PodState& a, const PodState& b, float time) {
+    float dx = b.pos.x - a.pos.x;
+    float dy = b.pos.y - a.pos.y;
+    // The L1 norm bounds the relative speed without a sqrt. One unit of slack covers rounding.
+    float reach = 2 * POD_RADIUS + 1 + (abs(b.vel.x - a.vel.x) + abs(b.vel.y - a.vel.y)) * time;
+    return dx * dx + dy * dy < reach * reach;
+}
+
+float Physics::maxTravel(const PodState& pod, int turns) {
+    // A pod thrusting flat out along its velocity, boosting on the first turn if it still can. The speed uses the
+    // L1 norm, which is never smaller than the real one, and each turn has two units of slack for truncation.
+    float speed = abs(pod.vel.x) + abs(pod.vel.y);
+    float travel = Drift(Vector(0, 0), Vector(speed, 0), Vector(MAX_THRUST, 0)).position(turns).x;
+    if(pod.boostAvailable) {
+        travel += (BOOST_ACC - MAX_THRUST) * Drift::dragSum(turns);
+    }
+    return travel + 2 * turns;
+}
+
+int Physics::cullPairs(PodState* pods[POD_COUNT*2], int turns) {
+    float travel[POD_COUNT*2];
+    for(int i = 0; i < POD_COUNT*2; i++) {
+        travel[i] = maxTravel(*pods[i], turns);
+    }
+    int culled = 0;
+    for(int i = 0; i < POD_COUNT*2; i++) {
+        for(int j = i + 1; j < POD_COUNT*2; j++) {
+            float reach = 2 * POD_RADIUS + travel[i] + travel[j];
+            if(Vector::distSq(pods[i]->pos, pods[j]->pos) > reach * reach) {
+                culled |= pairBit(i, j);
+            }
+        }
+    }
+    return culled;
+}
+
+bool Physics::isIsolated(int culledPairs, int pod) {
+    return (culledPairs & podPairs(pod)) == podPairs(pod);
+}
+
 bool Collision::testForCollision(PodState& a, PodState& b, Collision* collision) {
     // Vectors are cleaner, but slower.
     float pathStartX = b.pos.x - a.pos.x;
@@ -254,8 +397,8 @@ PodState Physics::move(const PodState& pod, const PodOutputAbs& control, float t
     int nextCheckpoint = pod.nextCheckpoint;
     // This checkpoint check can be removed the move method slit into two types (as many uses of
     // move don't need this reasonably expensive check).
-    if(passedCheckpoint(pod.pos, pos, race.checkpoints[pod.nextCheckpoint])) {
-        nextCheckpoint = (nextCheckpoint + 1) % race.checkpoints.size();
+    if(passedCheckpoint(pod.pos, pos, race->checkpoints[pod.nextCheckpoint])) {
+        nextCheckpoint = (nextCheckpoint + 1) % race->checkpoints.size();
     }
     pos.x = (int) pos.x;//round(pos.x);
     pos.y = (int) pos.y;//round(pos.y);
@@ -351,21 +494,41 @@ bool Physics::isCollision(const PodState &podA, const PodOutputAbs &controlA, co
     PodOutputAbs cB = controlB;
     PodState a = podA;
     PodState b = podB;
-    for(int i = 0; i < turns; i++) {
+    float velThresholdSq = velThreshold * velThreshold;
+    int i = 0;
+    // Step while either pod is still turning towards its force. Once both face it, they keep the same thrust
+    // vector and the rest is closed form.
+    while(i < turns && !(facesForce(a, relativeForceA) && facesForce(b, relativeForceB))) {
         cA.target = a.pos + relativeForceA;
         cB.target = b.pos + relativeForceB;
         a = move(a, cA, 1);
         b = move(b, cB, 1);
+        i++;
         Vector velDiff = a.vel - b.vel;
-        bool isCollision = (a.pos - b.pos).getLength() < 2 * POD_RADIUS;
-        bool meetsVelThreshold = abs(velDiff.getLength()) >= abs(velThreshold);
-        if(isCollision && meetsVelThreshold) {
+        if(Vector::distSq(a.pos, b.pos) < 4 * POD_RADIUS_SQ && velDiff.getLengthSq() >= velThresholdSq) {
+            return true;
+        }
+    }
+    Drift relative(a.pos - b.pos, a.vel - b.vel, constantForce(a, relativeForceA, controlA.thrust) -
+                                                 constantForce(b, relativeForceB, controlB.thrust));
+    for(int k = 1; i + k <= turns; k++) {
+        if(relative.position(k).getLengthSq() < 4 * POD_RADIUS_SQ &&
+           relative.velocity(k).getLengthSq() >= velThresholdSq) {
             return true;
         }
     }
     return false;
 }
 
+bool Physics::facesForce(const PodState& pod, const Vector& relativeForce) {
+    // Same test as move() uses to clamp the turn, so it agrees with stepping.
+    return abs(angleTo(pod.pos, pod.pos + relativeForce) - pod.angle) <= MAX_ANGLE;
+}
+
+Vector Physics::constantForce(const PodState& pod, const Vector& relativeForce, float thrust) {
+    return Vector::fromMagAngle(thrust, angleTo(pod.pos, pod.pos + relativeForce));
+}
+
 // Used for legacy pod.
 PodOutputAbs Physics::expectedControl(const PodState& previous, const PodState& current) {
     Vector force = (current.vel * (1/DRAG)) - previous.vel;
@@ -376,13 +539,17 @@ PodOutputAbs Physics::expectedControl(const PodState& previous, const PodState&
 // Used for legacy pod.
 PodState Physics::extrapolate(const PodState& pod, const PodOutputAbs& control, int turns) {
     Vector relativeForce = control.target - pod.pos;
-    PodOutputAbs updatedControl;
-    // Can either use simulation or geometric sums.
     PodState p = pod;
-    for(int i = 0; i < turns; i++) {
-        updatedControl = PodOutputAbs(control.thrust, pod.pos + relativeForce);
-        p = move(p, updatedControl, turns);
+    int i = 0;
+    for(; i < turns && !facesForce(p, relativeForce); i++) {
+        p = move(p, PodOutputAbs(control.thrust, p.pos + relativeForce), 1);
     }
+    if(i == turns) return p;
+    // The pod now faces its force, so the remaining turns are closed form. Checkpoint progress isn't tracked there.
+    Drift drift(p.pos, p.vel, constantForce(p, relativeForce, control.thrust));
+    p.angle = angleTo(p.pos, p.pos + relativeForce);
+    p.pos = drift.position(turns - i);
+    p.vel = drift.velocity(turns - i);
     return p;
 }
 
@@ -392,10 +559,10 @@ int Physics::leadPodID(PodState pods[]) {
         return 0;
     } else {
         // Another bottleneck spot, so resorting to manual computation.
-        float diffX1 = race.checkpoints[pods[0].nextCheckpoint].x - pods[0].pos.x;
-        float diffY1 = race.checkpoints[pods[0].nextCheckpoint].y - pods[0].pos.y;
-        float diffX2 = race.checkpoints[pods[1].nextCheckpoint].x - pods[1].pos.x;
-        float diffY2 = race.checkpoints[pods[1].nextCheckpoint].y - pods[1].pos.y;
+        float diffX1 = race->checkpoints[pods[0].nextCheckpoint].x - pods[0].pos.x;
+        float diffY1 = race->checkpoints[pods[0].nextCheckpoint].y - pods[0].pos.y;
+        float diffX2 = race->checkpoints[pods[1].nextCheckpoint].x - pods[1].pos.x;
+        float diffY2 = race->checkpoints[pods[1].nextCheckpoint].y - pods[1].pos.y;
         if(pods[1].passedCheckpoints > pods[0].passedCheckpoints ||
            (diffX1*diffX1 + diffY1*diffY1) > (diffX2*diffX2 + diffY2*diffY2)) {
             return 1;
@@ -5,12 +5,31 @@
 #include "Vector.h"
 #include "Bot.h"
 
+/**
+ * What happened during one simulated turn, in enough detail to replay a single pod through the same turn without
+ * the others (see Physics::simulateAlone()). A turn is split into substeps at each collision; the positions and
+ * speeds of every pod at the start of each substep are kept.
+ */
+struct TurnLog {
+    static const int MAX_SUBSTEPS = 6;
+    struct Motion {
+        float x, y, vx, vy;
+    };
+    // -1 if the turn had too many collisions to log.
+    int substeps = 0;
+    float moveTime[MAX_SUBSTEPS];
+    bool endsInCollision[MAX_SUBSTEPS];
+    Motion pods[MAX_SUBSTEPS][POD_COUNT*2];
+    // Bit i is set if pod i collided during the turn.
+    int collided = 0;
+};
+
 class Physics {
-    Race race;
+    const Race* race = nullptr;
 public:
     Physics() {}
 
-    Physics(const Race &race) : race(race) {}
+    Physics(RaceRef race) : race(race.get()) {}
 
     /**
      * Simulates the movement of a pod for a given time.
@@ -45,9 +64,25 @@ public:
     bool isCollision(const PodState &podA, const PodOutputAbs &controlA,
                      const PodState &podB, const PodOutputAbs &controlB, float velThreshold);
 
+    /**
+     * Whether the pods come within collision distance, with at least the given relative speed, at the end of any
+     * of the next turns, each repeating its control (as a force relative to its position). Only the turns in which
+     * a pod is still turning towards its force are stepped; the rest uses Drift.
+     */
     bool isCollision(const PodState &podA, const PodOutputAbs &controlA,
                      const PodState &podB, const PodOutputAbs &controlB, int turns, float velThreshold);
 
+    /**
+     * Whether the pod's next move towards the force leaves it facing the force, after which it keeps a constant
+     * thrust vector.
+     */
+    static bool facesForce(const PodState &pod, const Vector &relativeForce);
+
+    /**
+     * The thrust vector of a pod that faces its force.
+     */
+    static Vector constantForce(const PodState &pod, const Vector &relativeForce, float thrust);
+
     /**
      * Guess the next pod's output based on its previous and current state.
      */
@@ -80,6 +115,65 @@ public:
 
     void simulate(PodState **pods);
 
+    /**
+     * Simulate a turn of a single pod, with its controls already applied, as if no other pod were there. Returns
+     * whether it passed its next checkpoint.
+     */
+    bool simulateSolo(PodState &pod) const;
+
+    /**
+     * Simulate a turn, skipping the pairs of pods in culledPairs (see cullPairs()). Pairs involving a pod that
+     * collides are removed from culledPairs, as its speed is no longer bounded.
+     */
+    void simulate(PodState **pods, int &culledPairs, TurnLog *log = nullptr);
+
+    /**
+     * Replay one pod through a logged turn, as if simulate() had been run on all of them with this pod's new state.
+     * This only holds if the pod doesn't touch any of the others, in either the logged turn or the replay; if it
+     * might, returns false and the turn must be simulated in full. Otherwise the log is updated with the pod's new
+     * motion.
+     */
+    bool simulateAlone(PodState &pod, int podIdx, TurnLog &log);
+
+    /**
+     * Broadphase for a substep: whether two pods could touch in the given fraction of a turn. Cheap and
+     * conservative; pods that fail it are skipped before the full collision test.
+     */
+    static bool canMeet(const PodState &a, const PodState &b, float time);
+
+    /**
+     * An upper bound on how far a pod can travel in the given number of turns, if nothing hits it.
+     */
+    static float maxTravel(const PodState &pod, int turns);
+
+    /**
+     * Broadphase for a horizon: the pairs of pods that can't touch in the given number of turns whatever their
+     * controls, as a mask of pairBit()s. It stays valid for simulate() until a pod of the pair collides with
+     * something, which simulate() takes care of.
+     */
+    static int cullPairs(PodState **pods, int turns);
+
+    /**
+     * A bit for each of the six pairs of pods.
+     */
+    static int pairBit(int i, int j) {
+        // Pairs (0,1), (0,2), (0,3), (1,2), (1,3), (2,3) are bits 0 to 5.
+        return 1 << (i == 0 ? j - 1 : i + j);
+    }
+
+    /**
+     * The bits of every pair the pod is part of.
+     */
+    static int podPairs(int pod) {
+        static const int pairs[POD_COUNT*2] = {0x07, 0x19, 0x2a, 0x34};
+        return pairs[pod];
+    }
+
+    /**
+     * Whether no other pod can reach the pod, given a mask from cullPairs().
+     */
+    static bool isIsolated(int culledPairs, int pod);
+
     bool orderByProgress(PodState *pods);
 
     int leadPodID(PodState *pods);
@@ -98,7 +192,7 @@ class PassedCheckpoint : public Event {
     PassedCheckpoint(PodState& pod, float time, int nextCP) : mPod(&pod), mTime(time), mNextCheckpoint(nextCP) {}
 public:
     PassedCheckpoint() {}
-    bool static testForPassedCheckpoint(PodState& a, Race& r, PassedCheckpoint* event, bool isEnemy);
+    bool static testForPassedCheckpoint(PodState& a, const Race& r, PassedCheckpoint* event, bool isEnemy);
 
     float time() const {return mTime;}
     void resolve();
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <iomanip>
+
+#include "PhysicsRegression.h"
+
+void ErrorHistogram::add(float error) {
+    int bucket = 0;
+    if(error > 0) {
+        bucket = 1;
+        while(bucket < BUCKETS - 1 && error > bucketLimit(bucket)) bucket++;
+    }
+    counts[bucket]++;
+    total++;
+    sum += error;
+    if(error > max) max = error;
+}
+
+float ErrorHistogram::bucketLimit(int bucket) {
+    return bucket == 0 ? 0 : (float) (1 << (bucket - 1));
+}
+
+void ErrorHistogram::print(ostream& out) const {
+    out << "  mean " << mean() << ", max " << max << endl;
+    for(int b = 0; b < BUCKETS; b++) {
+        if(counts[b] == 0) continue;
+        if(b == 0) {
+            out << "  " << setw(10) << "0";
+        } else if(b == BUCKETS - 1) {
+            out << "  " << setw(10) << ("> " + to_string((int) bucketLimit(b - 1)));
+        } else {
+            out << "  " << setw(10) << ("<= " + to_string((int) bucketLimit(b)));
+        }
+        out << " " << setw(10) << counts[b] << " (" << fixed << setprecision(3)
+            << 100.0 * counts[b] / total << "%)" << defaultfloat << endl;
+    }
+}
+
+void RegressionReport::print(ostream& out) const {
+    out << "Turns: " << turns << ", exact: " << exactTurns << ", checkpoint mismatches: " << checkpointMismatches
+        << endl;
+    out << "Position error (units):" << endl;
+    posError.print(out);
+    out << "Velocity error (units/turn):" << endl;
+    velError.print(out);
+    out << "Angle error (degrees):" << endl;
+    angleError.print(out);
+    if(throughputTurns > 0) {
+        out << "Throughput: " << (long) turnsPerSecond() << " turns/s (" << 1e9 * throughputSeconds / throughputTurns
+            << " ns/turn over " << throughputTurns << " turns)" << endl;
+    }
+}
+
+int PhysicsRegression::add(const ReplayReader& reader) {
+    int raceIndex = races.size();
+    races.push_back(reader.race());
+    int added = 0;
+    for(int t = 0; t + 1 < reader.turnCount(); t++) {
+        const replay::TurnRecord& turn = reader.turn(t);
+        const replay::TurnRecord& next = reader.turn(t + 1);
+        // The final turn of a game carries no actions.
+        if(!(turn.actions[0].flags & replay::ActionRecord::VALID)) continue;
+        Case c;
+        c.raceIndex = raceIndex;
+        for(int i = 0; i < replay::REPLAY_PODS; i++) {
+            c.before[i] = replay::unpack(turn.pods[i]);
+            c.actions[i] = replay::unpack(turn.actions[i]);
+            c.after[i] = replay::unpack(next.pods[i]);
+        }
+        cases.push_back(c);
+        added++;
+    }
+    return added;
+}
+
+int PhysicsRegression::addPath(const string& path) {
+    DIR* dir = opendir(path.c_str());
+    if(!dir) {
+        ReplayReader reader;
+        if(!reader.open(path)) return -1;
+        add(reader);
+        return 1;
+    }
+    // Sort so that case order, and so the report, does not depend on the directory listing order.
+    vector<string> files;
+    while(dirent* entry = readdir(dir)) {
+        string name = entry->d_name;
+        if(name.size() > 5 && name.compare(name.size() - 5, 5, ".csbr") == 0) {
+            files.push_back(path + "/" + name);
+        }
+    }
+    closedir(dir);
+    sort(files.begin(), files.end());
+    int read = 0;
+    for(const string& file : files) {
+        ReplayReader reader;
+        if(reader.open(file)) {
+            add(reader);
+            read++;
+        }
+    }
+    return read;
+}
+
+void PhysicsRegression::step(Physics& physics, const Case& c, PodState out[]) {
+    PodState* pods[replay::REPLAY_PODS];
+    for(int i = 0; i < replay::REPLAY_PODS; i++) {
+        out[i] = c.before[i];
+        Physics::apply(out[i], c.actions[i]);
+        pods[i] = &out[i];
+    }
+    physics.simulate(pods);
+}
+
+vector<Physics> PhysicsRegression::bindPhysics() const {
+    vector<Physics> sims;
+    for(const Race& race : races) {
+        sims.push_back(Physics(race));
+    }
+    return sims;
+}
+
+RegressionReport PhysicsRegression::check() const {
+    RegressionReport report;
+    vector<Physics> sims = bindPhysics();
+    PodState out[replay::REPLAY_PODS];
+    for(const Case& c : cases) {
+        step(sims[c.raceIndex], c, out);
+        bool exact = true;
+        for(int i = 0; i < replay::REPLAY_PODS; i++) {
+            const PodState& expected = c.after[i];
+            float posError = (out[i].pos - expected.pos).getLength();
+            float velError = (out[i].vel - expected.vel).getLength();
+            float angleError = abs(out[i].angle - expected.angle);
+            if(angleError > M_PI) angleError = 2 * M_PI - angleError;
+            angleError = Physics::radToDegrees(angleError);
+            report.posError.add(posError);
+            report.velError.add(velError);
+            report.angleError.add(angleError);
+            bool checkpointsMatch = out[i].nextCheckpoint == expected.nextCheckpoint &&
+                                    out[i].passedCheckpoints == expected.passedCheckpoints;
+            if(!checkpointsMatch) report.checkpointMismatches++;
+            exact = exact && checkpointsMatch && posError == 0 && velError == 0 && angleError == 0;
+        }
+        report.turns++;
+        if(exact) report.exactTurns++;
+    }
+    return report;
+}
+
+void PhysicsRegression::measureThroughput(RegressionReport& report, double minSeconds) const {
+    if(cases.empty()) return;
+    vector<Physics> sims = bindPhysics();
+    PodState out[replay::REPLAY_PODS];
+    // Keeps the results observable so the simulation can't be optimized away.
+    float checksum = 0;
+    long turns = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    while(elapsed < minSeconds || turns == 0) {
+        for(const Case& c : cases) {
+            step(sims[c.raceIndex], c, out);
+            checksum += out[0].pos.x;
+        }
+        turns += cases.size();
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    volatile float sink = checksum;
+    (void) sink;
+    report.throughputTurns = turns;
+    report.throughputSeconds = elapsed;
+}
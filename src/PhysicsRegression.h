@@ -0,0 +1,118 @@
+#ifndef CODERSSTRIKEBACK_PHYSICSREGRESSION_H
+#define CODERSSTRIKEBACK_PHYSICSREGRESSION_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "State.h"
+#include "Physics.h"
+#include "Replay.h"
+
+/**
+ * Counts errors in power-of-two buckets: exactly 0, (0, 1], (1, 2], (2, 4], ... with the last bucket open-ended.
+ */
+class ErrorHistogram {
+public:
+    static const int BUCKETS = 12;
+
+    long counts[BUCKETS] = {};
+    long total = 0;
+    double sum = 0;
+    float max = 0;
+
+    void add(float error);
+
+    /**
+     * The upper bound of a bucket. The last bucket has no upper bound.
+     */
+    static float bucketLimit(int bucket);
+
+    double mean() const {
+        return total == 0 ? 0 : sum / total;
+    }
+
+
+    void print(ostream& out) const;
+};
+
+struct RegressionReport {
+    long turns = 0;
+    // Turns where every pod matched the recording exactly.
+    long exactTurns = 0;
+    // Pod-turns where the next checkpoint or checkpoint count differed from the recording.
+    long checkpointMismatches = 0;
+    ErrorHistogram posError;
+    ErrorHistogram velError;
+    ErrorHistogram angleError;
+
+    long throughputTurns = 0;
+    double throughputSeconds = 0;
+
+    double turnsPerSecond() const {
+        return throughputSeconds > 0 ? throughputTurns / throughputSeconds : 0;
+    }
+
+    void print(ostream& out) const;
+};
+
+/**
+ * Replays recorded games through Physics and compares every turn with what was recorded.
+ *
+ * Each recorded turn with actions becomes a case: the four pods before the turn, the actions taken and the four pods
+ * the recording says came out. Cases are loaded once into memory, so the same states double as a realistic workload
+ * for measuring simulation throughput.
+ *
+ * Any change to the physics (a faster collision loop, SIMD, fixed-point, batching) should leave the error histograms
+ * where they were.
+ *
+ * The replays are recorded by our own simulator (paramSim --record), so this checks that Physics still does what it
+ * did, not that it matches the game's referee: a difference that was already there is recorded with it, and can't be
+ * found this way. There is no importer for the referee's own game logs.
+ */
+class PhysicsRegression {
+    struct Case {
+        int raceIndex;
+        PodState before[replay::REPLAY_PODS];
+        PodOutputSim actions[replay::REPLAY_PODS];
+        PodState after[replay::REPLAY_PODS];
+    };
+
+    vector<Race> races;
+    vector<Case> cases;
+
+    static void step(Physics& physics, const Case& c, PodState out[]);
+
+    vector<Physics> bindPhysics() const;
+
+public:
+    /**
+     * Add every turn with recorded actions from a replay.
+     *
+     * @return the number of cases added.
+     */
+    int add(const ReplayReader& reader);
+
+    /**
+     * Add every replay (.csbr) file in a directory, or a single replay file.
+     *
+     * @return the number of files read, or -1 if the path could not be read.
+     */
+    int addPath(const string& path);
+
+    int caseCount() const {
+        return cases.size();
+    }
+
+    /**
+     * Re-simulate every case once and collect the error histograms.
+     */
+    RegressionReport check() const;
+
+    /**
+     * Re-simulate all cases repeatedly, for at least minSeconds, and record the throughput into the report.
+     */
+    void measureThroughput(RegressionReport& report, double minSeconds) const;
+};
+
+#endif //CODERSSTRIKEBACK_PHYSICSREGRESSION_H
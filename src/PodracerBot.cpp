@@ -6,12 +6,12 @@
 // TODO: got integer overflow (-max int) output on one game. Not sure why.
 PodOutputAbs Racer::move(GameState& gameState, int podID) {
 // Where should these two go...
-    Navigation nav(gameState.race);
-    Physics physics(gameState.race);
+    Navigation nav(*gameState.race);
+    Physics physics(*gameState.race);
     PodState& pod = gameState.ourState().pods[podID];
-    Vector ck = gameState.race.checkpoints[pod.nextCheckpoint];
+    Vector ck = gameState.race->checkpoints[pod.nextCheckpoint];
     PodOutputAbs move;
-    if(pod.passedCheckpoints == gameState.race.laps * gameState.race.checkpoints.size() - 1) {
+    if(pod.passedCheckpoints == gameState.race->laps * gameState.race->checkpoints.size() - 1) {
         // Last checkpoint, no need to line-up the following checkpoint.
 //        cerr << "Last Checkpoint!" << endl;
         move = nav.turnSaturationAdjust(pod, nav.seek(pod, ck));
@@ -45,7 +45,7 @@ PodOutputAbs Racer::move(GameState& gameState, int podID) {
     if(pod.boostAvailable && move.thrust != PodOutputAbs::SHIELD) {
         float boostAngleLimit = M_PI * (4.0 / 180.0);
         float minimumDistFactor = 0.8;
-        float distThreshold = gameState.race.maxCheckpointDist * minimumDistFactor;
+        float distThreshold = gameState.race->maxCheckpointDist * minimumDistFactor;
         if(abs(physics.angleTo(pod.pos, ck) - pod.angle) < boostAngleLimit &&
            (ck - pod.pos).getLength() >= distThreshold) {
             move.thrust = PodOutputAbs::BOOST;
@@ -56,8 +56,8 @@ PodOutputAbs Racer::move(GameState& gameState, int podID) {
 }
 
 PodOutputAbs Bouncer::move(GameState& gameState, int podID) {
-    Navigation nav(gameState.race);
-    Physics physics(gameState.race);
+    Navigation nav(*gameState.race);
+    Physics physics(*gameState.race);
     PodState& pod = gameState.ourState().pods[podID];
     int returnBuffer = 20;
     PodOutputAbs move;
@@ -67,26 +67,26 @@ PodOutputAbs Bouncer::move(GameState& gameState, int podID) {
         PodState& leadPod = gameState.enemyState().leadPod();
         int leadID = gameState.enemyState().leadPodID;
         // Need a tidier way of finding the nextNextCP.
-        int nextNextCP = (leadPod.nextCheckpoint + 1) % gameState.race.checkpoints.size();
-        if(gameState.turn > 0 && target == gameState.race.checkpoints[nextNextCP]) {
+        int nextNextCP = (leadPod.nextCheckpoint + 1) % gameState.race->checkpoints.size();
+        if(gameState.turn > 0 && target == gameState.race->checkpoints[nextNextCP]) {
 //            cerr << "Targeting next next CP: " << nextNextCP << endl;
             // Move towards target and spin towards enemy.
             PodState nextPos = physics.move(leadPod, physics.expectedControl(gameState.enemyState().lastPods[leadID], leadPod), 1);
             int turnThreshold = 8;
             int seekThreshold = 0;
-            move =  nav.preemptSeek(pod, gameState.race.checkpoints[nextNextCP], CHECKPOINT_RADIUS*3, nextPos.pos,
+            move =  nav.preemptSeek(pod, gameState.race->checkpoints[nextNextCP], CHECKPOINT_RADIUS*3, nextPos.pos,
                                     turnThreshold, seekThreshold);
         } else {
 //            cerr << "Intercepting pod: " << leadID << endl;
             move = nav.intercept(pod, gameState.enemyState().leadPod());
         }
     } else {
-        move = nav.turnSaturationAdjust(pod, nav.seek(pod, gameState.race.checkpoints[pod.nextCheckpoint]));
+        move = nav.turnSaturationAdjust(pod, nav.seek(pod, gameState.race->checkpoints[pod.nextCheckpoint]));
         if(pod.boostAvailable && move.thrust != PodOutputAbs::SHIELD) {
             float boostAngleLimit = M_PI * (5.0 / 180.0);
             float minimumDistFactor = 0.7;
-            Vector ck = gameState.race.checkpoints[pod.nextCheckpoint];
-            float distThreshold = gameState.race.maxCheckpointDist * minimumDistFactor;
+            Vector ck = gameState.race->checkpoints[pod.nextCheckpoint];
+            float distThreshold = gameState.race->maxCheckpointDist * minimumDistFactor;
             if(abs(physics.angleTo(pod.pos, ck) - pod.angle) < boostAngleLimit &&
                (ck - pod.pos).getLength() >= distThreshold) {
                 move.thrust = PodOutputAbs::BOOST;
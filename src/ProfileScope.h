@@ -0,0 +1,19 @@
+#ifndef CODERSSTRIKEBACK_PROFILESCOPE_H
+#define CODERSSTRIKEBACK_PROFILESCOPE_H
+
+/**
+ * The PROFILE_* macros that mark the search's hot path for the Profiler. Unless CSB_PROFILE is defined they expand to
+ * nothing and the profiler isn't even included, so that it stays out of the merged bot (see merge.py).
+ */
+#ifdef CSB_PROFILE
+#include "Profiler.h"
+#define PROFILE_SCOPE(event) Profiler::Scope profileScope(Profiler::event)
+#define PROFILE_COUNT(event) (Profiler::local().counts[Profiler::event]++)
+#define PROFILE_DUMP(label) Profiler::dump(std::cerr, label, Profiler::take())
+#else
+#define PROFILE_SCOPE(event)
+#define PROFILE_COUNT(event)
+#define PROFILE_DUMP(label)
+#endif
+
+#endif //CODERSSTRIKEBACK_PROFILESCOPE_H
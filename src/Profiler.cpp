@@ -0,0 +1,46 @@
+#include <sstream>
+
+#include "Profiler.h"
+
+Profiler::Stats& Profiler::Stats::operator+=(const Stats& other) {
+    for(int i = 0; i < EVENT_COUNT; i++) {
+        counts[i] += other.counts[i];
+        ticks[i] += other.ticks[i];
+    }
+    return *this;
+}
+
+const char* Profiler::name(Event event) {
+    static const char* names[EVENT_COUNT] = {"simulate", "substep", "collisionTest", "collision", "checkpointTest",
+                                             "simulateAlone", "score", "randomEdit", "loopControl", "tail"};
+    return names[event];
+}
+
+Profiler::Stats Profiler::take() {
+#ifdef CSB_PROFILE
+    Stats stats = local();
+    local() = Stats();
+    return stats;
+#else
+    return Stats();
+#endif
+}
+
+void Profiler::dump(std::ostream& out, const std::string& label, const Stats& stats) {
+    // Built up front so that lines from threads dumping at the same time don't interleave.
+    std::ostringstream text;
+    uint64_t scores = stats.counts[SCORE];
+    for(int i = 0; i < EVENT_COUNT; i++) {
+        uint64_t count = stats.counts[i];
+        if(count == 0) continue;
+        text << "[profile " << label << "] " << name((Event) i) << ": " << count;
+        if(scores > 0) {
+            text << " (" << (double) count / scores << "/score)";
+        }
+        if(stats.ticks[i] > 0) {
+            text << ", " << stats.ticks[i] << " ticks, " << (double) stats.ticks[i] / count << "/call";
+        }
+        text << '\n';
+    }
+    out << text.str() << std::flush;
+}
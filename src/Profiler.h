@@ -0,0 +1,93 @@
+#ifndef CODERSSTRIKEBACK_PROFILER_H
+#define CODERSSTRIKEBACK_PROFILER_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#ifdef CSB_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+/**
+ * Event counters and scoped timers for the search's hot path.
+ *
+ * Everything is compiled out unless CSB_PROFILE is defined (cmake -DCSB_PROFILE=ON): the PROFILE_* macros (see
+ * ProfileScope.h) expand to nothing and take() returns empty stats. When on, each thread counts into its own Stats, so there are no atomics or
+ * allocations on the hot path; a thread hands its counts over with take(), to be summed and dumped wherever a unit of
+ * work ends (a turn in main, a job in paramSim).
+ *
+ * Timers read the TSC where there is one, so their totals are in cycles, not seconds.
+ */
+class Profiler {
+public:
+    enum Event {
+        SIMULATE,        // Physics::simulate(), one per turn of all four pods.
+        SUBSTEP,         // The part of a turn up to the next collision.
+        COLLISION_TEST,  // Pairs that got past the broadphase to Collision::testForCollision().
+        COLLISION,       // Collisions resolved.
+        CHECKPOINT_TEST, // PassedCheckpoint::testForPassedCheckpoint() calls.
+        SIMULATE_ALONE,  // Physics::simulateAlone() calls.
+        SCORE,           // Rollouts scored by a search bot.
+        RANDOM_EDIT,
+        LOOP_CONTROL,    // Annealing schedule updates.
+        TAIL,            // Rollouts carried on past the search horizon (SearchBot::tailTurns).
+        EVENT_COUNT
+    };
+
+    struct Stats {
+        uint64_t counts[EVENT_COUNT] = {};
+        uint64_t ticks[EVENT_COUNT] = {};
+
+        Stats& operator+=(const Stats& other);
+    };
+
+#ifdef CSB_PROFILE
+    static Stats& local() {
+        static thread_local Stats stats;
+        return stats;
+    }
+
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /**
+     * Counts an event and adds the time until the end of the enclosing scope to it.
+     */
+    class Scope {
+        Event event;
+        uint64_t start;
+    public:
+        explicit Scope(Event event) : event(event), start(now()) {}
+
+        ~Scope() {
+            Stats& stats = local();
+            stats.counts[event]++;
+            stats.ticks[event] += now() - start;
+        }
+    };
+#endif
+
+    static const char* name(Event event);
+
+    /**
+     * This thread's stats since the last take(), which starts them again from zero.
+     */
+    static Stats take();
+
+    /**
+     * One line per event that happened: its count, its count per rollout scored and, for timed events, the total
+     * and mean ticks.
+     */
+    static void dump(std::ostream& out, const std::string& label, const Stats& stats);
+};
+
+#endif //CODERSSTRIKEBACK_PROFILER_H
@@ -0,0 +1,120 @@
+#include <assert.h>
+#include <cstdio>
+#include <cstring>
+
+#include "RaceGenerator.h"
+
+// Mixes the generator seed and race index into an independent seed for each race.
+static uint64_t splitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+vector<Vector> RaceGenerator::generateCheckpoints(uint64_t index) {
+    std::mt19937_64 rng(splitMix64(seed ^ splitMix64(index)));
+    std::uniform_int_distribution<int> countDist(MIN_CHECKPOINTS, MAX_CHECKPOINTS);
+    std::uniform_int_distribution<int> xDist(border, MAP_WIDTH - border);
+    std::uniform_int_distribution<int> yDist(border, MAP_HEIGHT - border);
+    static const int MAX_ATTEMPTS = 1000;
+    // Rounds of MAX_ATTEMPTS placements tried with the fewest checkpoints before giving up.
+    static const int MAX_ROUNDS = 100;
+    int count = countDist(rng);
+    for(int round = 0; round < MAX_ROUNDS; ) {
+        vector<Vector> checkpoints;
+        for(int attempt = 0; attempt < MAX_ATTEMPTS && (int) checkpoints.size() < count; attempt++) {
+            Vector candidate(xDist(rng), yDist(rng));
+            bool tooClose = false;
+            for(const Vector& cp : checkpoints) {
+                if(Vector::distSq(cp, candidate) < (float) minSpacing * minSpacing) {
+                    tooClose = true;
+                    break;
+                }
+            }
+            if(!tooClose) checkpoints.push_back(candidate);
+        }
+        if((int) checkpoints.size() == count) return checkpoints;
+        // Unlucky placement left no room; drop a checkpoint rather than loop forever.
+        if(count > MIN_CHECKPOINTS) {
+            count--;
+        } else {
+            round++;
+        }
+    }
+    // The spacing and border leave no room for MIN_CHECKPOINTS.
+    return vector<Vector>();
+}
+
+Race RaceGenerator::generate(uint64_t index) {
+    vector<Vector> checkpoints = generateCheckpoints(index);
+    assert(!checkpoints.empty());
+    return Race(laps, checkpoints);
+}
+
+RaceCorpus RaceCorpus::generate(uint64_t seed, int count) {
+    RaceCorpus corpus;
+    corpus.seed = seed;
+    RaceGenerator generator(seed);
+    for(int i = 0; i < count; i++) {
+        vector<Vector> checkpoints = generator.generateCheckpoints(i);
+        assert(!checkpoints.empty());
+        RaceRecord record;
+        memset(&record, 0, sizeof(RaceRecord));
+        record.laps = generator.laps;
+        record.checkpointCount = checkpoints.size();
+        for(int c = 0; c < (int) checkpoints.size(); c++) {
+            record.checkpoints[c][0] = (int32_t) checkpoints[c].x;
+            record.checkpoints[c][1] = (int32_t) checkpoints[c].y;
+        }
+        corpus.records.push_back(record);
+    }
+    return corpus;
+}
+
+Race RaceCorpus::race(int index) const {
+    const RaceRecord& record = records[index];
+    vector<Vector> checkpoints;
+    for(int c = 0; c < record.checkpointCount; c++) {
+        checkpoints.push_back(Vector(record.checkpoints[c][0], record.checkpoints[c][1]));
+    }
+    return Race(record.laps, checkpoints);
+}
+
+static const char CORPUS_MAGIC[4] = {'C', 'S', 'B', 'C'};
+
+bool RaceCorpus::save(const string& path) const {
+    FILE* f = fopen(path.c_str(), "wb");
+    if(!f) return false;
+    uint32_t version = VERSION;
+    uint32_t count = records.size();
+    bool ok = fwrite(CORPUS_MAGIC, sizeof(CORPUS_MAGIC), 1, f) == 1 &&
+              fwrite(&version, sizeof(version), 1, f) == 1 &&
+              fwrite(&count, sizeof(count), 1, f) == 1 &&
+              fwrite(&seed, sizeof(seed), 1, f) == 1 &&
+              (count == 0 || fwrite(records.data(), sizeof(RaceRecord), count, f) == count);
+    return fclose(f) == 0 && ok;
+}
+
+bool RaceCorpus::load(const string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if(!f) return false;
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint64_t fileSeed;
+    bool ok = fread(magic, sizeof(magic), 1, f) == 1 && memcmp(magic, CORPUS_MAGIC, sizeof(magic)) == 0 &&
+              fread(&version, sizeof(version), 1, f) == 1 && version == VERSION &&
+              fread(&count, sizeof(count), 1, f) == 1 &&
+              fread(&fileSeed, sizeof(fileSeed), 1, f) == 1;
+    vector<RaceRecord> loaded(ok ? count : 0);
+    ok = ok && (count == 0 || fread(loaded.data(), sizeof(RaceRecord), count, f) == count);
+    fclose(f);
+    if(!ok) return false;
+    for(const RaceRecord& r : loaded) {
+        if(r.checkpointCount < MIN_CHECKPOINTS || r.checkpointCount > MAX_CHECKPOINTS) return false;
+    }
+    records.swap(loaded);
+    seed = fileSeed;
+    return true;
+}
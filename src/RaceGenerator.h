@@ -0,0 +1,98 @@
+#ifndef CODERSSTRIKEBACK_RACEGENERATOR_H
+#define CODERSSTRIKEBACK_RACEGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "State.h"
+
+static const int MAP_WIDTH = 16000;
+static const int MAP_HEIGHT = 9000;
+static const int MIN_CHECKPOINTS = 3;
+static const int RACE_LAPS = 3;
+
+/**
+ * Creates random races that follow the game's rules: 3-8 checkpoints, all inside the map and kept apart by a
+ * minimum spacing.
+ *
+ * Race i of a generator depends only on (seed, i), so any single race can be regenerated without the others.
+ */
+class RaceGenerator {
+    uint64_t seed;
+
+public:
+    int minSpacing = 2000;
+    // Keep checkpoints far enough from the edge that the start grid (see Simulation::initializePods) fits.
+    int border = 1000;
+    int laps = RACE_LAPS;
+
+    RaceGenerator(uint64_t seed) : seed(seed) {}
+
+    /**
+     * Race index. The spacing and border must leave room for MIN_CHECKPOINTS.
+     */
+    Race generate(uint64_t index);
+
+    /**
+     * The checkpoints of race index, or none if minSpacing and border leave no room for MIN_CHECKPOINTS of them.
+     */
+    vector<Vector> generateCheckpoints(uint64_t index);
+};
+
+/**
+ * A fixed-size corpus record. The fixed size is what allows random access by index.
+ */
+struct RaceRecord {
+    int32_t laps;
+    int32_t checkpointCount;
+    int32_t checkpoints[MAX_CHECKPOINTS][2];
+};
+
+/**
+ * A versioned file of pre-generated races. The whole file is loaded up front so evaluation workers can read any map,
+ * in any order, from several threads without waiting on generation or I/O.
+ *
+ * Layout: "CSBC", uint32 version, uint32 count, uint64 seed, then count RaceRecords.
+ */
+class RaceCorpus {
+    vector<RaceRecord> records;
+    uint64_t seed = 0;
+
+public:
+    static const uint32_t VERSION = 1;
+
+    RaceCorpus() {}
+
+    static RaceCorpus generate(uint64_t seed, int count);
+
+    bool load(const string& path);
+
+    bool save(const string& path) const;
+
+    int size() const {
+        return records.size();
+    }
+
+    bool empty() const {
+        return records.empty();
+    }
+
+    uint64_t generatorSeed() const {
+        return seed;
+    }
+
+    Race race(int index) const;
+
+    /**
+     * Pick a race uniformly at random.
+     */
+    template<typename RNG>
+    Race sample(RNG& rng) const {
+        std::uniform_int_distribution<int> pick(0, size() - 1);
+        return race(pick(rng));
+    }
+};
+
+#endif //CODERSSTRIKEBACK_RACEGENERATOR_H
@@ -0,0 +1,116 @@
+#include <cmath>
+
+#include "RacingLines.h"
+#include "Drift.h"
+
+// Drift compensations (turns of the pod's speed taken off its aim) and switch-over times (turns of coasting left
+// before the checkpoint) tried for each line.
+static const int LINE_DRIFT_TURNS = 5;
+static const int LINE_SWITCH_TURNS = 6;
+
+RacingLines::RacingLines(RaceRef race) : race(race.get()), physics(race), lines(race->checkpoints.size()) {
+    const int count = race->checkpoints.size();
+    for(int cp = 0; cp < count; cp++) {
+        const Vector& from = race->checkpoints[(cp + count - 1) % count];
+        // Entering along the course, from the checkpoint before.
+        Vector along = (from - race->checkpoints[(cp + count - 2) % count]).normalize();
+        lines[cp].resize(ENTRY_SPEEDS);
+        for(int e = 0; e < ENTRY_SPEEDS; e++) {
+            PodState start(from, along * (e * entrySpeedStep), Physics::angleTo(from, race->checkpoints[cp]), cp);
+            Line& best = lines[cp][e];
+            for(int drift = 0; drift < LINE_DRIFT_TURNS; drift++) {
+                for(int switchTurns = 0; switchTurns < LINE_SWITCH_TURNS; switchTurns++) {
+                    Line line = fly(start, drift, switchTurns);
+                    if(best.pods.empty() || better(line, best)) {
+                        best = line;
+                    }
+                }
+            }
+        }
+    }
+}
+
+PodOutputSim RacingLines::policy(const PodState& pod, int driftTurns, int switchTurns) const {
+    int target = pod.nextCheckpoint;
+    Drift coast(pod.pos, pod.vel, Vector(0, 0));
+    if(switchTurns > 0 && coast.firstTurnWithin(race->checkpoints[target], CHECKPOINT_RADIUS, switchTurns) >= 0) {
+        target = race->followingCheckpoint(target);
+    }
+    Vector aim = race->checkpoints[target] - pod.vel * driftTurns;
+    float turn = Vector::distSq(pod.pos, aim) < 1 ? 0 : Physics::turnAngle(pod, aim);
+    int thrust = abs(turn) < M_PI / 2 ? (int) (MAX_THRUST * cos(turn)) : 0;
+    return PodOutputSim(thrust, max(-MAX_ANGLE, min(MAX_ANGLE, turn)), false, false);
+}
+
+RacingLines::Line RacingLines::fly(PodState pod, int driftTurns, int switchTurns) const {
+    Line line;
+    line.pods.push_back(pod);
+    for(int t = 0; t < MAX_TURNS; t++) {
+        PodOutputSim control = policy(pod, driftTurns, switchTurns);
+        Physics::apply(pod, control);
+        bool passed = physics.simulateSolo(pod);
+        line.controls.push_back(control);
+        line.pods.push_back(pod);
+        if(passed) break;
+    }
+    return line;
+}
+
+bool RacingLines::better(const Line& a, const Line& b) const {
+    bool aPassed = a.pods.back().passedCheckpoints > a.pods.front().passedCheckpoints;
+    bool bPassed = b.pods.back().passedCheckpoints > b.pods.front().passedCheckpoints;
+    if(aPassed != bPassed) return aPassed;
+    if(a.controls.size() != b.controls.size()) return a.controls.size() < b.controls.size();
+    return onwardSpeed(a.pods.back()) > onwardSpeed(b.pods.back());
+}
+
+float RacingLines::onwardSpeed(const PodState& pod) const {
+    Vector onward = race->checkpoints[pod.nextCheckpoint] - pod.pos;
+    return onward.getLengthSq() < 1 ? 0 : pod.vel.dotProduct(onward.normalize());
+}
+
+float RacingLines::distance(const PodState& a, const PodState& b) {
+    float heading = abs(a.angle - b.angle);
+    heading = heading > M_PI ? 2 * M_PI - heading : heading;
+    return Vector::dist(a.pos, b.pos) + speedWeight * Vector::dist(a.vel, b.vel) + headingWeight * heading;
+}
+
+bool RacingLines::match(const PodState& racer, PodOutputSim controls[], int turns) const {
+    PodState pod = racer;
+    int filled = 0;
+    while(filled < turns) {
+        const Line* nearest = nullptr;
+        int from = 0;
+        float nearestDistance = matchLimit;
+        for(const Line& line : lines[pod.nextCheckpoint]) {
+            for(int i = 0; i < (int) line.controls.size(); i++) {
+                float d = distance(pod, line.pods[i]);
+                if(d < nearestDistance) {
+                    nearestDistance = d;
+                    nearest = &line;
+                    from = i;
+                }
+            }
+        }
+        if(!nearest) break;
+        for(int i = from; i < (int) nearest->controls.size() && filled < turns; i++) {
+            controls[filled++] = nearest->controls[i];
+        }
+        // On through the checkpoint after, from where this line passed its checkpoint.
+        pod = nearest->pods.back();
+    }
+    if(filled == 0) return false;
+    for(; filled < turns; filled++) {
+        controls[filled] = PodOutputSim(MAX_THRUST, 0, false, false);
+    }
+    return true;
+}
+
+void RacingLines::startSeed(PairOutput plan[], int turns) const {
+    const Line& line = into(1);
+    PodOutputSim straight(MAX_THRUST, 0, false, false);
+    for(int t = 0; t < turns; t++) {
+        PodOutputSim control = t < (int) line.controls.size() ? line.controls[t] : straight;
+        plan[t] = PairOutput(control, control);
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef CODERSSTRIKEBACK_RACINGLINES_H
+#define CODERSSTRIKEBACK_RACINGLINES_H
+
+#include <vector>
+
+#include "State.h"
+#include "Physics.h"
+
+/**
+ * A library of racing lines into each checkpoint of a race, flown once (e.g. in the long first turn) and reused after.
+ *
+ * A line starts on the previous checkpoint, facing the next, at one of a few entry speeds along the course. It is
+ * flown by a simple policy: aim at the checkpoint less some of the pod's drift, with less thrust the further the pod
+ * has to turn, and aim at the following checkpoint instead once coasting would carry the pod through. Of a few amounts
+ * of drift compensation and switch-over times, the line keeps the one that passes the checkpoint soonest, and then
+ * with the most speed towards the following checkpoint.
+ *
+ * A racer anywhere on the course is matched to the nearest state on any line into its next checkpoint (see match()),
+ * and the line's controls from there make a seed for the search.
+ */
+class RacingLines {
+public:
+    // Longest line flown. Checkpoints are never further apart than a pod at full thrust goes in that many turns.
+    static const int MAX_TURNS = 40;
+    // Lines into each checkpoint, one per entry speed.
+    static const int ENTRY_SPEEDS = 4;
+    static constexpr float entrySpeedStep = 250;
+
+    struct Line {
+        // The controls of each turn, until the checkpoint is passed.
+        vector<PodOutputSim> controls;
+        // The pod at the start of each turn, and after the last one.
+        vector<PodState> pods;
+    };
+
+private:
+    // How far apart, in units of position, a difference of one in speed and of one radian in heading count when
+    // matching.
+    static constexpr float speedWeight = 4;
+    static constexpr float headingWeight = 2000;
+    // Farthest a racer can be from every line and still be matched to one.
+    static constexpr float matchLimit = 2500;
+
+    const Race* race = nullptr;
+    Physics physics;
+    // The lines into each checkpoint, indexed by that checkpoint and then the entry speed.
+    vector<vector<Line>> lines;
+
+    PodOutputSim policy(const PodState& pod, int driftTurns, int switchTurns) const;
+
+    Line fly(PodState pod, int driftTurns, int switchTurns) const;
+
+    /**
+     * Whether line a is better than line b, for the checkpoint both fly into.
+     */
+    bool better(const Line& a, const Line& b) const;
+
+    /**
+     * The pod's speed towards its next checkpoint.
+     */
+    float onwardSpeed(const PodState& pod) const;
+
+    static float distance(const PodState& a, const PodState& b);
+
+public:
+    RacingLines() {}
+
+    RacingLines(RaceRef race);
+
+    /**
+     * The line into the checkpoint from the given entry speed, standing (0) by default.
+     */
+    const Line& into(int checkpoint, int entrySpeed = 0) const {
+        return lines[checkpoint][entrySpeed];
+    }
+
+    /**
+     * The controls for the racer to follow the lines from the state on them nearest to it, through the checkpoints
+     * after as well. Returns false, with nothing written, if the racer is too far from every line.
+     */
+    bool match(const PodState& racer, PodOutputSim controls[], int turns) const;
+
+    /**
+     * The first turns of the line into the first checkpoint, for both pods of a start grid, as a seed for the search.
+     * Turns past the end of the line are straight on at full thrust.
+     */
+    void startSeed(PairOutput plan[], int turns) const;
+};
+
+#endif //CODERSSTRIKEBACK_RACINGLINES_H
@@ -0,0 +1,58 @@
+#ifndef CODERSSTRIKEBACK_RANDOM_H
+#define CODERSSTRIKEBACK_RANDOM_H
+
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * Small, fast generator (xorshift64*) owned by each bot. Unlike rand(), it is not shared between threads and can be
+ * seeded, so two bots given the same seed make the same random choices.
+ */
+class Random {
+    uint64_t state;
+
+public:
+    // Unseeded generators draw from rand() so the live bot still varies from game to game.
+    Random() {
+        seed(((uint64_t) std::rand() << 32) ^ (uint64_t) std::rand());
+    }
+
+    Random(uint64_t s) {
+        seed(s);
+    }
+
+    void seed(uint64_t s) {
+        // Scramble so that nearby seeds give unrelated streams; the state must never be zero.
+        s += 0x9E3779B97F4A7C15ULL;
+        s = (s ^ (s >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        s = (s ^ (s >> 27)) * 0x94D049BB133111EBULL;
+        state = (s ^ (s >> 31)) | 1;
+    }
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    // In [0, n).
+    int nextInt(int n) {
+        return (int) ((next() >> 33) % (uint64_t) n);
+    }
+
+    // In [0, 1).
+    float nextFloat() {
+        return (next() >> 40) * (1.0f / (1 << 24));
+    }
+
+    /**
+     * Derive a seed for a sub-stream, e.g. one bot on one turn of a seeded game.
+     */
+    static uint64_t mix(uint64_t seed, uint64_t a, uint64_t b = 0) {
+        Random r(seed ^ (a * 0xD6E8FEB86659FD93ULL) ^ (b * 0xA0761D6478BD642FULL));
+        return r.next();
+    }
+};
+
+#endif //CODERSSTRIKEBACK_RANDOM_H
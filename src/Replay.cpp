@@ -0,0 +1,143 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Replay.h"
+
+namespace replay {
+
+PodRecord pack(const PodState& pod) {
+    PodRecord r;
+    memset(&r, 0, sizeof(PodRecord));
+    r.x = pod.pos.x;
+    r.y = pod.pos.y;
+    r.vx = pod.vel.x;
+    r.vy = pod.vel.y;
+    r.angle = pod.angle;
+    r.nextCheckpoint = pod.nextCheckpoint;
+    r.passedCheckpoints = pod.passedCheckpoints;
+    r.turnsSinceCP = pod.turnsSinceCP;
+    r.turnsSinceShield = pod.turnsSinceShield;
+    r.flags = (pod.shieldEnabled ? PodRecord::SHIELD_ENABLED : 0) | (pod.boostAvailable ? PodRecord::BOOST_AVAILABLE : 0);
+    return r;
+}
+
+PodState unpack(const PodRecord& r) {
+    PodState pod(Vector(r.x, r.y), Vector(r.vx, r.vy), r.angle, r.nextCheckpoint);
+    pod.passedCheckpoints = r.passedCheckpoints;
+    pod.turnsSinceCP = r.turnsSinceCP;
+    pod.turnsSinceShield = r.turnsSinceShield;
+    pod.shieldEnabled = (r.flags & PodRecord::SHIELD_ENABLED) != 0;
+    pod.boostAvailable = (r.flags & PodRecord::BOOST_AVAILABLE) != 0;
+    return pod;
+}
+
+ActionRecord pack(const PodOutputSim& action) {
+    ActionRecord r;
+    memset(&r, 0, sizeof(ActionRecord));
+    r.angle = action.angle;
+    r.thrust = action.thrust;
+    r.flags = ActionRecord::VALID | (action.shieldEnabled ? ActionRecord::SHIELD : 0) |
+              (action.boostEnabled ? ActionRecord::BOOST : 0);
+    return r;
+}
+
+PodOutputSim unpack(const ActionRecord& r) {
+    return PodOutputSim(r.thrust, r.angle, (r.flags & ActionRecord::SHIELD) != 0, (r.flags & ActionRecord::BOOST) != 0);
+}
+
+Race unpackRace(const Header& header) {
+    vector<Vector> checkpoints;
+    for(int i = 0; i < header.checkpointCount; i++) {
+        checkpoints.push_back(Vector(header.checkpoints[i][0], header.checkpoints[i][1]));
+    }
+    return Race(header.laps, checkpoints);
+}
+
+}
+
+bool ReplayWriter::open(const string& path, const Race& race) {
+    close();
+    if(race.checkpoints.size() > replay::MAX_REPLAY_CHECKPOINTS) return false;
+    file = fopen(path.c_str(), "wb");
+    if(!file) return false;
+    // Large enough that a whole game is usually flushed in a handful of writes.
+    setvbuf(file, nullptr, _IOFBF, 1 << 16);
+    replay::Header header;
+    memset(&header, 0, sizeof(replay::Header));
+    memcpy(header.magic, replay::MAGIC, sizeof(header.magic));
+    header.version = replay::VERSION;
+    header.recordSize = sizeof(replay::TurnRecord);
+    header.laps = race.laps;
+    header.checkpointCount = race.checkpoints.size();
+    for(int i = 0; i < race.checkpoints.size(); i++) {
+        header.checkpoints[i][0] = (int32_t) race.checkpoints[i].x;
+        header.checkpoints[i][1] = (int32_t) race.checkpoints[i].y;
+    }
+    if(fwrite(&header, sizeof(header), 1, file) != 1) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ReplayWriter::writeTurn(PodState* const pods[], const PairOutput* aActions, const PairOutput* bActions) {
+    if(!file) return;
+    replay::TurnRecord record;
+    memset(&record, 0, sizeof(replay::TurnRecord));
+    for(int i = 0; i < replay::REPLAY_PODS; i++) {
+        record.pods[i] = replay::pack(*pods[i]);
+    }
+    if(aActions && bActions) {
+        record.actions[0] = replay::pack(aActions->o1);
+        record.actions[1] = replay::pack(aActions->o2);
+        record.actions[2] = replay::pack(bActions->o1);
+        record.actions[3] = replay::pack(bActions->o2);
+    }
+    fwrite(&record, sizeof(record), 1, file);
+}
+
+void ReplayWriter::close() {
+    if(file) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool ReplayReader::open(const string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(replay::Header)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    if(mapped == MAP_FAILED) return false;
+    data = static_cast<const char*>(mapped);
+    size = st.st_size;
+    const replay::Header& h = header();
+    if(memcmp(h.magic, replay::MAGIC, sizeof(h.magic)) != 0 || h.version != replay::VERSION ||
+       h.recordSize != sizeof(replay::TurnRecord) || h.checkpointCount < 1 ||
+       h.checkpointCount > replay::MAX_REPLAY_CHECKPOINTS) {
+        close();
+        return false;
+    }
+    // A partially written last record (e.g. from a killed process) is ignored.
+    turns = (size - sizeof(replay::Header)) / sizeof(replay::TurnRecord);
+    return true;
+}
+
+void ReplayReader::close() {
+    if(data) {
+        munmap(const_cast<char*>(data), size);
+        data = nullptr;
+        size = 0;
+        turns = 0;
+    }
+}
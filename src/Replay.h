@@ -0,0 +1,154 @@
+#ifndef CODERSSTRIKEBACK_REPLAY_H
+#define CODERSSTRIKEBACK_REPLAY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "State.h"
+
+/**
+ * Binary replay format.
+ *
+ * A header holding the race, then one fixed-size TurnRecord per turn: the four pods at the start of the turn (player 1
+ * pod 1, player 1 pod 2, player 2 pod 1, player 2 pod 2) and the action each took that turn. The last turn of a game
+ * has no actions. Records are appended as the game is played, so the turn count is given by the file size.
+ */
+namespace replay {
+
+static const char MAGIC[4] = {'C', 'S', 'B', 'R'};
+static const uint32_t VERSION = 1;
+static const int MAX_REPLAY_CHECKPOINTS = MAX_CHECKPOINTS;
+static const int REPLAY_PODS = POD_COUNT * PLAYER_COUNT;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+    int32_t laps;
+    int32_t checkpointCount;
+    int32_t checkpoints[MAX_REPLAY_CHECKPOINTS][2];
+};
+
+struct PodRecord {
+    float x;
+    float y;
+    float vx;
+    float vy;
+    float angle;
+    int16_t nextCheckpoint;
+    int16_t passedCheckpoints;
+    int16_t turnsSinceCP;
+    int16_t turnsSinceShield;
+    uint8_t flags;
+    uint8_t padding[3];
+
+    static const uint8_t SHIELD_ENABLED = 1;
+    static const uint8_t BOOST_AVAILABLE = 2;
+};
+
+struct ActionRecord {
+    float angle;
+    int16_t thrust;
+    uint8_t flags;
+    uint8_t padding;
+
+    static const uint8_t SHIELD = 1;
+    static const uint8_t BOOST = 2;
+    // Set on every action of a played turn; clear on the final turn of a game.
+    static const uint8_t VALID = 4;
+};
+
+struct TurnRecord {
+    PodRecord pods[REPLAY_PODS];
+    ActionRecord actions[REPLAY_PODS];
+};
+
+static_assert(sizeof(PodRecord) == 32, "Replay pod records must stay fixed-size.");
+static_assert(sizeof(ActionRecord) == 8, "Replay action records must stay fixed-size.");
+static_assert(sizeof(TurnRecord) == 160, "Replay turn records must stay fixed-size.");
+
+PodRecord pack(const PodState& pod);
+
+PodState unpack(const PodRecord& record);
+
+ActionRecord pack(const PodOutputSim& action);
+
+PodOutputSim unpack(const ActionRecord& record);
+
+Race unpackRace(const Header& header);
+
+}
+
+/**
+ * Appends turns to a replay file as the game is played. Writes go through a stdio buffer, so a turn costs a memcpy
+ * and only every few hundred turns reach the file.
+ */
+class ReplayWriter {
+    FILE* file = nullptr;
+
+public:
+    ReplayWriter() {}
+
+    ~ReplayWriter() {
+        close();
+    }
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const string& path, const Race& race);
+
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    /**
+     * @param pods the four pods at the start of the turn.
+     * @param aActions, bActions each player's actions this turn. Leave out for the final turn of a game.
+     */
+    void writeTurn(PodState* const pods[], const PairOutput* aActions = nullptr, const PairOutput* bActions = nullptr);
+
+    void close();
+};
+
+/**
+ * Memory-maps a replay file for reading. Turns are read in place; nothing is copied or parsed up front.
+ */
+class ReplayReader {
+    const char* data = nullptr;
+    size_t size = 0;
+    int turns = 0;
+
+public:
+    ReplayReader() {}
+
+    ~ReplayReader() {
+        close();
+    }
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    bool open(const string& path);
+
+    void close();
+
+    const replay::Header& header() const {
+        return *reinterpret_cast<const replay::Header*>(data);
+    }
+
+    Race race() const {
+        return replay::unpackRace(header());
+    }
+
+    int turnCount() const {
+        return turns;
+    }
+
+    const replay::TurnRecord& turn(int i) const {
+        return reinterpret_cast<const replay::TurnRecord*>(data + sizeof(replay::Header))[i];
+    }
+};
+
+#endif //CODERSSTRIKEBACK_REPLAY_H
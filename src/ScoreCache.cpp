@@ -0,0 +1,58 @@
+#include <cstring>
+
+#include "ScoreCache.h"
+
+static uint64_t mixBits(uint64_t x) {
+    // The splitmix64 finalizer.
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+ScoreCache::Stats& ScoreCache::Stats::operator+=(const Stats& other) {
+    for(int i = 0; i < PHASES; i++) {
+        lookups[i] += other.lookups[i];
+        hits[i] += other.hits[i];
+    }
+    return *this;
+}
+
+uint64_t ScoreCache::turnHash(int turn, const PairOutput& output) {
+    uint32_t angles[2];
+    memcpy(&angles[0], &output.o1.angle, sizeof(float));
+    memcpy(&angles[1], &output.o2.angle, sizeof(float));
+    uint64_t controls = (uint64_t) output.o1.thrust << 20 | (uint64_t) output.o2.thrust << 8 |
+                        output.o1.shieldEnabled << 3 | output.o1.boostEnabled << 2 |
+                        output.o2.shieldEnabled << 1 | output.o2.boostEnabled;
+    uint64_t h = mixBits(((uint64_t) angles[0] << 32 | angles[1]) ^ mixBits(controls << 8 | (uint64_t) turn));
+    return h & ~(uint64_t) 1;
+}
+
+uint64_t ScoreCache::hash(const PairOutput solution[], int turns) {
+    uint64_t h = 1;
+    for(int t = 0; t < turns; t++) {
+        h ^= turnHash(t, solution[t]);
+    }
+    return h;
+}
+
+void ScoreCache::clear() {
+    memset(slots, 0, sizeof(slots));
+    counts = Stats();
+}
+
+bool ScoreCache::lookup(uint64_t key, float progress, float& score) {
+    int phase = progress >= 1 ? PHASES - 1 : (int) (progress * PHASES);
+    counts.lookups[phase]++;
+    const Slot& slot = slots[key >> (64 - SIZE_BITS)];
+    if(slot.key != key) return false;
+    counts.hits[phase]++;
+    score = slot.score;
+    return true;
+}
+
+void ScoreCache::store(uint64_t key, float score) {
+    Slot& slot = slots[key >> (64 - SIZE_BITS)];
+    slot.key = key;
+    slot.score = score;
+}
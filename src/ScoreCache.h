@@ -0,0 +1,69 @@
+#ifndef CODERSSTRIKEBACK_SCORECACHE_H
+#define CODERSSTRIKEBACK_SCORECACHE_H
+
+#include <cstdint>
+
+#include "State.h"
+
+/**
+ * Scores of the solutions a search has already rolled out, so that one proposed again isn't resimulated.
+ *
+ * The annealer's edits draw from a small set of controls, so late in the cooling, when the solution barely moves, many
+ * proposals are ones it has scored before. A solution is keyed by a Zobrist-style hash: the xor of a hash of each
+ * turn's controls and the turn, which an edit of one turn updates with two xors. The table is direct mapped and small
+ * enough to clear for every search; a slot keeps the last solution hashed to it.
+ */
+class ScoreCache {
+public:
+    static const int SIZE_BITS = 12;
+    static const int SIZE = 1 << SIZE_BITS;
+    // Hits are counted separately for each part of the search, by how far it has cooled.
+    static const int PHASES = 4;
+
+    struct Stats {
+        long lookups[PHASES] = {};
+        long hits[PHASES] = {};
+
+        Stats& operator+=(const Stats& other);
+
+        double hitRate(int phase) const {
+            return lookups[phase] == 0 ? 0 : (double) hits[phase] / lookups[phase];
+        }
+    };
+
+    /**
+     * The hash of one turn's controls, to be xored in and out of a solution's. Its lowest bit is always 0, so that a
+     * solution's hash, which starts from 1, never is.
+     */
+    static uint64_t turnHash(int turn, const PairOutput& output);
+
+    static uint64_t hash(const PairOutput solution[], int turns);
+
+    /**
+     * Forget every score, and the stats, e.g. for a new search.
+     */
+    void clear();
+
+    /**
+     * The score of the solution with this hash, if it is in the cache. Progress (0 to 1) through the search is for
+     * the stats.
+     */
+    bool lookup(uint64_t key, float progress, float& score);
+
+    void store(uint64_t key, float score);
+
+    const Stats& stats() const {
+        return counts;
+    }
+
+private:
+    struct Slot {
+        // 0 for an empty slot; hashes are never 0.
+        uint64_t key;
+        float score;
+    };
+    Slot slots[SIZE];
+    Stats counts;
+};
+
+#endif //CODERSSTRIKEBACK_SCORECACHE_H
@@ -0,0 +1,865 @@
+#ifndef CODERSSTRIKEBACK_SEARCHBOT_H
+#define CODERSSTRIKEBACK_SEARCHBOT_H
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstring>
+#include <assert.h>
+#include <limits>
+#include <cstdlib>
+#include <chrono>
+
+#include "State.h"
+#include "Bot.h"
+#include "Physics.h"
+#include "ProfileScope.h"
+#include "RacingLines.h"
+#include "Random.h"
+#include "ScoreCache.h"
+#include "SearchBudget.h"
+
+
+struct ScoreFactors {
+    // Racer
+    float overallRacer;
+    float passCPBonus;
+    float progressToCP;
+    float enemyProgress;
+    float earlyPassBonus;
+    // Bouncer
+    float overallBouncer;
+    float enemyDist;
+    float enemyDistToCP;
+    float bouncerDistToCP;
+    float angleSeenByCP;
+    float angleSeenByEnemy;
+    float bouncerTurnAngle;
+    float enemyTurnAngle;
+    float checkpointPenalty;
+    float skirtBonus;
+    float shieldPenalty;
+};
+
+static ScoreFactors defaultFactors = {
+        1,    // overallRacer
+        202, // passCPBonus
+        1.14,    // progressToCP
+        -0.80, // enemyProgress
+        1200, // earlyPassBonus
+        1,    // overallBouncer
+        -0.28, // enemyDist
+        1.87, // enemyDistToCP
+        -1.47,  // bouncerDistToCP
+        -0.78,  // angleSeenByCP
+        -0.134,  // angleSeenByEnemy
+        -0.528,  // bouncerTurnAngle
+        -0.448,  // enemyTurn angle
+        -4918,   // checkpoint penalty
+        2000,  // Skirt bonus
+        -200  // shield penalty
+};
+
+
+class CustomAI : public SimBot {
+    const PairOutput* moves;
+    int turn = 0;
+public:
+    CustomAI(const PairOutput moves[], int startFromTurn) :
+            moves(moves), turn(startFromTurn) {}
+
+    void setTurn(int fromTurn) {
+        turn = fromTurn;
+    }
+
+    void move(PodState ourPods[], PodState enemyPods[]) {
+        Physics::apply(ourPods, moves[turn++]);
+    }
+};
+
+/**
+ * Bot with very low computational requirements.
+ */
+class MinimalBot : public SimBot {
+    const Race* race = nullptr;
+    Physics physics;
+    static constexpr float angleThreshold = MAX_ANGLE;
+    static constexpr float cutOff = M_PI/2 + MAX_ANGLE;
+public:
+    MinimalBot() {}
+
+    MinimalBot(RaceRef race) {
+        init(race);
+    }
+
+    void init(RaceRef r) {
+        race = r.get();
+        physics = Physics(r);
+    }
+
+    Vector bouncerTarget(const PodState& bouncer, const PodState& enemyRacer) const {
+        Vector target = race->checkpoints[enemyRacer.nextCheckpoint];
+        float targetx;
+        float targety;
+        if((target.x - bouncer.pos.x)*(target.x - bouncer.pos.x) + (target.y - bouncer.pos.y) * (target.y - bouncer.pos.y) >
+           (target.x - enemyRacer.pos.x)*(target.x - enemyRacer.pos.x) + (target.y - enemyRacer.pos.y)*(target.y - enemyRacer.pos.y)) {
+            int nextNextCPID = race->followingCheckpoint(enemyRacer.nextCheckpoint);
+            targetx = race->checkpoints[nextNextCPID].x;
+            targety = race->checkpoints[nextNextCPID].y;
+        }
+        else {
+            targetx = enemyRacer.pos.x + (race->checkpoints[enemyRacer.nextCheckpoint].x - enemyRacer.pos.x) * 0.80;
+            targety = enemyRacer.pos.y + (race->checkpoints[enemyRacer.nextCheckpoint].y - enemyRacer.pos.y) * 0.80;
+        }
+        return Vector(targetx, targety);
+    }
+
+    Vector racerTarget(const PodState& racer) const {
+        Vector drift = racer.vel * 3.5;
+        return race->checkpoints[racer.nextCheckpoint] - drift;
+    }
+
+    /**
+     * Controls that turn the pod towards the target, with full thrust unless it has to turn further than it can.
+     * These are what moveRacer() and moveBouncer() aim for, as a solution the search can start from.
+     */
+    static PodOutputSim output(const PodState& pod, const Vector& target) {
+        static constexpr float closeEnough = 26;
+        float turnAngle = Vector::distSq(pod.pos, target) < closeEnough ? 0 : Physics::turnAngle(pod, target);
+        int thrust = MAX_THRUST;
+        if(abs(turnAngle) > MAX_ANGLE) {
+            thrust = max(0, MAX_THRUST - int(((abs(turnAngle) - angleThreshold) / (cutOff - angleThreshold)) * MAX_THRUST));
+            turnAngle = turnAngle < 0 ? -MAX_ANGLE : MAX_ANGLE;
+        }
+        return PodOutputSim(thrust, turnAngle, false, false);
+    }
+
+    PodOutputSim racerOutput(const PodState* ourPods) const {
+        return output(ourPods[0], racerTarget(ourPods[0]));
+    }
+
+    PodOutputSim bouncerOutput(const PodState* ourPods, const PodState* enemyPods) const {
+        return output(ourPods[1], bouncerTarget(ourPods[1], enemyPods[0]));
+    }
+
+    void moveBouncer(PodState* ourPods, PodState* enemyPods) {
+        // Bouncer
+        Vector target = bouncerTarget(ourPods[1], enemyPods[0]);
+        float turnAngle = physics.turnAngle(ourPods[1],target);
+        Vector force;
+        if(abs(turnAngle) > MAX_ANGLE) {
+            float thrust = MAX_THRUST - int(((abs(turnAngle) - angleThreshold) / (cutOff - angleThreshold)) * MAX_THRUST);
+            turnAngle = turnAngle < 0 ? max(-MAX_ANGLE, turnAngle) : min(MAX_ANGLE, turnAngle);
+            force = Vector::fromMagAngle(thrust, turnAngle);
+        } else {
+            force = target.normalize() * MAX_THRUST;
+        }
+        ourPods[1].vel.x += force.x;
+        ourPods[1].vel.y += force.y;
+        ourPods[1].vel.resetLengths();
+        ourPods[1].addAngle(turnAngle);
+    }
+
+    void moveRacer(PodState* ourPods, PodState* enemyPods) {
+        // Racer
+        Vector target = racerTarget(ourPods[0]);
+        float turnAngle;
+        // It is possible that the target happens to be the pods position. This will cause a NaN to be returned from
+        // turnAngle(ourPods[0], target). Therefore, check for this case and use 0 instead.
+        static constexpr float closeEnough = 26;
+        if(Vector::distSq(ourPods[0].pos, target) < closeEnough) {
+            turnAngle = 0;
+        }else {
+            turnAngle = physics.turnAngle(ourPods[0], target);
+        }
+        Vector force;
+        if(abs(turnAngle) > MAX_ANGLE) {
+            float thrust = (int) MAX_THRUST - int(((abs(turnAngle) - angleThreshold) / (cutOff - angleThreshold)) * MAX_THRUST);
+            // Turn angle should be rounded to the nearest degree also.
+            turnAngle = turnAngle < 0 ? max(-MAX_ANGLE, turnAngle) : min(MAX_ANGLE, turnAngle);
+            force = Vector::fromMagAngle(thrust, turnAngle);
+        } else {
+            force = target.normalize() * MAX_THRUST;
+        }
+        ourPods[0].vel.x += force.x;
+        ourPods[0].vel.y += force.y;
+        ourPods[0].vel.resetLengths();
+        ourPods[0].addAngle(turnAngle);
+    }
+
+    /**
+     * ourPods and enemyPods must be orderd by progress; it is assumed that ourPods[0] is our lead pod.
+     */
+    void move(PodState* ourPods, PodState* enemyPods) {
+        moveRacer(ourPods, enemyPods);
+        moveBouncer(ourPods, enemyPods);
+    };
+
+    int opponentPodsRead(int ourPod) const {
+        // The bouncer goes after the opponent's racer; the racer ignores everyone.
+        return ourPod == 0 ? 0 : 0x1;
+    }
+};
+
+
+template<int TURNS>
+class CustomAIWithBackup : public SimBot {
+    const PairOutput* moves;
+    const PodState (*enemyStates)[2];
+    MinimalBot backup;
+    int turn;
+    int defaultAfter = -1;
+public:
+    CustomAIWithBackup(RaceRef race, const PairOutput moves[], const PodState enemyStates[TURNS][2], int startFromTurn):
+            moves(moves), enemyStates(enemyStates), backup(race), turn(startFromTurn) {}
+
+    void setTurn(int fromTurn) {
+        turn = fromTurn;
+    }
+
+    /**
+     * Start following the moves again from the first turn. The moves and states are read through the pointers given
+     * on construction, so refilling those arrays and resetting is all that's needed to reuse this between turns.
+     */
+    void reset() {
+        turn = 0;
+    }
+
+    void setDefaultAfter(int turn) {
+        defaultAfter = turn;
+    }
+
+    bool isEnemyRacerDataAccurate(int turn, PodState ourPods[], PodState enemyPods[]) {
+        float delta = Vector::dist(enemyStates[turn][0].pos, enemyPods[0].pos);
+        float distToEnemy = Vector::dist(ourPods[1].pos, enemyPods[0].pos);
+        return delta / distToEnemy < 2.0;
+    }
+
+    bool isEnemyBouncerDataAccurate(int turn, PodState ourPods[], PodState enemyPods[]) {
+        float delta = Vector::dist(enemyStates[turn][1].pos, enemyPods[1].pos);
+        float distToEnemy = Vector::dist(ourPods[0].pos, enemyPods[1].pos);
+        return delta / distToEnemy < 2.0;
+    }
+
+    int opponentPodsRead(int ourPod) const {
+        // Each pod follows its moves while the opponent's pod it has to deal with is where it was expected.
+        return ourPod == 0 ? 0x2 : 0x1;
+    }
+
+    void move(PodState ourPods[], PodState enemyPods[]) {
+        if(defaultAfter != -1 && turn >= defaultAfter) {
+            backup.move(ourPods, enemyPods);
+        } else {
+            if(isEnemyBouncerDataAccurate(turn, ourPods, enemyPods)) {
+                Physics::apply(ourPods[0], moves[turn].o1);
+            } else {
+                backup.moveRacer(ourPods, enemyPods);
+            }
+            if(isEnemyRacerDataAccurate(turn, ourPods, enemyPods)) {
+                Physics::apply(ourPods[1], moves[turn].o2);
+            } else {
+                backup.moveBouncer(ourPods, enemyPods);
+            }
+        }
+        turn++;
+    }
+};
+
+
+template<int TURNS>
+class SearchBot : public DuelBot {
+public:
+    ScoreFactors sFactors = defaultFactors;
+    // Each search also starts from simple policies' moves (see addPolicySeeds()).
+    bool usePolicySeeds = true;
+    // Turns our racer is carried on past the horizon before a rollout is scored (see simulateTail()), for a longer
+    // lookahead than TURNS at a fraction of the cost. 0 scores every pod as it is at the horizon.
+    int tailTurns = 0;
+    // What a tail turn costs, as a fraction of a rollout: selfplay_bench rolled out 14% fewer solutions a second with
+    // 3 tail turns, and 30% fewer with 6.
+    static constexpr float tailTurnCost = 0.06f;
+    // The annealer looks solutions it has scored before up in a cache instead of rolling them out again (see
+    // ScoreCache).
+    bool useScoreCache = true;
+protected:
+    static constexpr float maxScore = 400000;
+    static constexpr float minScore = 10000;
+    static const int UNSET = -1;
+    long long clockStart = UNSET;
+    SearchBudget budget;
+    // Rollouts scored by the current search.
+    int simCount = 0;
+    bool toDeleteEnemy = false;
+
+    const Race* race = nullptr;
+    Physics physics;
+    Random rng;
+    SimBot* enemyBot;
+    // The policy of the seed that moves our pods as the opponent's are modelled by default.
+    MinimalBot policyBot;
+    const RacingLines* racingLines = nullptr;
+    ScoreCache cache;
+    PairOutput previousSolution[TURNS];
+    bool hasPrevious = false;
+    // Solutions offered for the next search to start from (see addSeed()). Progress ordered once train() has them.
+    static const int MAX_SEEDS = 4;
+    PairOutput seeds[MAX_SEEDS][TURNS];
+    int seedCount = 0;
+    PodState enemySimHistory[TURNS + 1][POD_COUNT];
+    PodState ourSimHistory[TURNS + 1][POD_COUNT];
+    // What the rollout's turns looked like after the controls were applied and while they were simulated. With
+    // these, an edit to one of our pods only resimulates that pod until it first interacts with another.
+    PodState enemyControlled[TURNS][POD_COUNT];
+    TurnLog turnLogs[TURNS];
+    // The rollout from the edited turn on, put back if the edit is rejected.
+    PodState savedOurHistory[TURNS + 1][POD_COUNT];
+    PodState savedEnemyHistory[TURNS + 1][POD_COUNT];
+    PodState savedEnemyControlled[TURNS][POD_COUNT];
+    TurnLog savedTurnLogs[TURNS];
+    // Our racer at the end of the tail, if there is one.
+    PodState racerTail;
+
+    /**
+     * Score the solution, resimulating from startFromTurn. If only editedPod's controls (0 or 1) changed since the
+     * last rollout, that pod alone is resimulated for as long as nothing else depends on it.
+     */
+    float score(const PairOutput solution[], int startFromTurn, int editedPod = -1);
+
+    void simulate(SimBot *pods1Sim, SimBot *pods2Sim, int turns, int startFromTurn);
+
+    /**
+     * Carry our racer on for tailTurns past the horizon into racerTail, as MinimalBot would race it and alone, as if
+     * nothing collided: a solo turn costs a fraction of a turn of the rollout, which tests every pair of pods. The
+     * racer's progress is then scored from there, so a horizon state that sets up the next checkpoint well scores
+     * better. The other pods are scored at the horizon: carrying them on too, under a policy that doesn't chase or
+     * block like the search does, blurs the bouncer's terms and made the bot lose badly. The tail never shields, so
+     * the shield penalty is the same as without it.
+     */
+    void simulateTail();
+
+    /**
+     * Resimulate only our pod podIdx from the given turn, until the turn on which another pod could be affected by
+     * it: by colliding with it (in the new or the previous rollout), or by the opponent's controls changing with our
+     * pod's position. Returns that turn, or TURNS if there wasn't one.
+     */
+    int resimulatePod(const PairOutput solution[], int fromTurn, int podIdx);
+
+    /**
+     * The pods the rollouts start from.
+     */
+    void setStart(const PodState ourPods[], const PodState enemyPods[]) {
+        ourSimHistory[0][0] = ourPods[0];
+        ourSimHistory[0][1] = ourPods[1];
+        enemySimHistory[0][0] = enemyPods[0];
+        enemySimHistory[0][1] = enemyPods[1];
+    }
+
+    void saveRollout(int fromTurn);
+
+    void restoreRollout(int fromTurn);
+
+    /**
+     * Which pod has different controls, or -1 if both or neither do.
+     */
+    static int editedPod(const PairOutput& before, const PairOutput& after);
+
+    static bool sameOutput(const PodOutputSim& a, const PodOutputSim& b) {
+        return a.thrust == b.thrust && a.angle == b.angle && a.shieldEnabled == b.shieldEnabled &&
+               a.boostEnabled == b.boostEnabled;
+    }
+
+    static bool sameControlled(const PodState& a, const PodState& b) {
+        return a.vel.x == b.vel.x && a.vel.y == b.vel.y && a.angle == b.angle && a.shieldEnabled == b.shieldEnabled &&
+               a.turnsSinceShield == b.turnsSinceShield && a.boostAvailable == b.boostAvailable;
+    }
+
+    void randomSolution(PairOutput sol[]);
+
+    PairOutput random();
+
+    void randomEdit(PairOutput &po);
+
+    long long getTimeMilli() {
+        long long ms = chrono::duration_cast<chrono::milliseconds>(
+                chrono::system_clock::now().time_since_epoch()).count();
+        return ms;
+    }
+
+    /**
+     * Reset the search's state for a new move.
+     */
+    virtual void init() = 0;
+
+    /**
+     * Search for the best solution from the given (progress ordered) pods. The opponent's pods after each turn of
+     * that solution's rollout are written to enemyPodState.
+     */
+    virtual void _train(const PodState podsToTrain[], const PodState opponentPods[], PairOutput solution[],
+                        PodState* enemyPodState) = 0;
+
+public:
+    SearchBot(RaceRef r) : race(r.get()), physics(r), policyBot(r) {
+        enemyBot = new MinimalBot(r);
+        toDeleteEnemy = true;
+    }
+
+    SearchBot(RaceRef r, long allocatedTimeMilli) : SearchBot(r, SearchBudget::time(allocatedTimeMilli)) {}
+
+    SearchBot(RaceRef r, long allocatedTimeMilli, SimBot* enemyBot) :
+            SearchBot(r, SearchBudget::time(allocatedTimeMilli), enemyBot) {}
+
+    SearchBot(RaceRef r, SearchBudget budget) : budget(budget), race(r.get()), physics(r), policyBot(r) {
+        enemyBot = new MinimalBot(r);
+        toDeleteEnemy = true;
+    }
+
+    SearchBot(RaceRef r, SearchBudget budget, SimBot* enemyBot) :
+            budget(budget), race(r.get()), physics(r), enemyBot(enemyBot), policyBot(r) {
+    }
+
+    virtual ~SearchBot() {
+        if(toDeleteEnemy) {
+            delete (enemyBot);
+        }
+    }
+
+    void setEnemyAI(SimBot* enemyAI) {
+        if(toDeleteEnemy) delete(enemyBot);
+        enemyBot = enemyAI;
+        toDeleteEnemy = false;
+
+    }
+
+    /**
+     * Measure the next search's time budget from this time (see getTimeMilli) instead of from when the search starts,
+     * e.g. from when the turn's input arrived.
+     */
+    void startClockAt(long long milli) {
+        clockStart = milli;
+    }
+
+    /**
+     * Number of candidate solutions scored by the last search.
+     */
+    int rolloutCount() const {
+        return simCount;
+    }
+
+    /**
+     * How often the last search found a solution in the score cache. Empty unless useScoreCache was set.
+     */
+    const ScoreCache::Stats& cacheStats() const {
+        return cache.stats();
+    }
+
+    void setBudget(SearchBudget b) {
+        budget = b;
+    }
+
+    const SearchBudget& getBudget() const {
+        return budget;
+    }
+
+    /**
+     * Rollouts a ROLLOUTS budget pays for, once each has paid for its tail: the same budget buys the same search time
+     * whatever tailTurns is.
+     */
+    long rolloutBudget() const {
+        return (long) (budget.amount / (1 + tailTurns * tailTurnCost));
+    }
+
+    /**
+     * Fix the random stream, so that bots with the same seed, state and budget search identically.
+     */
+    void seed(uint64_t s) {
+        rng.seed(s);
+    }
+
+    /**
+     * Offer a solution for the next search to start from, e.g. from an opening book, with our pods in input order.
+     * Turns past the end of the plan are straight on at full thrust. A seed is only used by one search, and seeds past
+     * MAX_SEEDS are dropped.
+     */
+    void addSeed(const PairOutput plan[], int turns) {
+        if(seedCount == MAX_SEEDS) return;
+        PodOutputSim straight(MAX_THRUST, 0, false, false);
+        for(int i = 0; i < TURNS; i++) {
+            seeds[seedCount][i] = i < turns ? plan[i] : PairOutput(straight, straight);
+        }
+        seedCount++;
+    }
+
+    /**
+     * Racing lines for the seed that has the racer follow them. They must be for the bot's race, and outlive the bot.
+     */
+    void setRacingLines(const RacingLines* lines) {
+        racingLines = lines;
+    }
+
+    /**
+     * Seeds from simple policies, from the start set by setStart(): every pod moved as MinimalBot would, and, if there
+     * are racing lines, the racer following them with the bouncer as in the first seed.
+     */
+    void addPolicySeeds() {
+        if(seedCount == MAX_SEEDS) return;
+        PairOutput* minimal = seeds[seedCount++];
+        for(int t = 0; t < TURNS; t++) {
+            minimal[t] = PairOutput(policyBot.racerOutput(ourSimHistory[t]),
+                                    policyBot.bouncerOutput(ourSimHistory[t], enemySimHistory[t]));
+            CustomAI customAI(minimal, t);
+            enemyBot->setTurn(t);
+            simulate(&customAI, enemyBot, t + 1, t);
+        }
+        simCount++;
+        PodOutputSim line[TURNS];
+        if(racingLines && seedCount < MAX_SEEDS && racingLines->match(ourSimHistory[0][0], line, TURNS)) {
+            for(int t = 0; t < TURNS; t++) {
+                seeds[seedCount][t] = PairOutput(line[t], minimal[t].o2);
+            }
+            seedCount++;
+        }
+    }
+
+    float score(const PodState *pods[], const PodState *podsPrev[], const PodState *enemyPods[],
+                const PodState *enemyPodsPrev[]);
+
+    bool train(const PodState pods[], const PodState enemyPods[], PairOutput solution[], PodState* enemyPodState) {
+        init();
+        PodState ourPodsCopy[POD_COUNT];
+        PodState enemyPodsCopy[POD_COUNT];
+        memcpy(ourPodsCopy, pods, sizeof(PodState) * POD_COUNT);
+        memcpy(enemyPodsCopy, enemyPods, sizeof(PodState) * POD_COUNT);
+        bool switched = physics.orderByProgress(ourPodsCopy);
+        physics.orderByProgress(enemyPodsCopy);
+        if(switched) {
+            for(int s = 0; s < seedCount; s++) {
+                for(int i = 0; i < TURNS; i++) {
+                    swap(seeds[s][i].o1, seeds[s][i].o2);
+                }
+            }
+        }
+        if(usePolicySeeds) {
+            setStart(ourPodsCopy, enemyPodsCopy);
+            addPolicySeeds();
+        }
+        _train(ourPodsCopy, enemyPodsCopy, solution, enemyPodState);
+        seedCount = 0;
+        return switched;
+    }
+
+    PairOutput move(GameState& gameState) {
+        PairOutput solution[TURNS];
+        PodState enemyPodState[TURNS][2] ;
+        bool switched = train(gameState.ourState().pods, gameState.enemyState().pods, solution, enemyPodState[0]);
+        // Enable boost
+        PodState bouncer = gameState.ourState().pods[1];
+        PodState racer = gameState.ourState().pods[0];
+        PodState enemyRacer = gameState.enemyState().pods[0];
+        // Racer
+        if(gameState.ourState().pods[0].boostAvailable &&
+                solution[0].o1.thrust == MAX_THRUST && solution[0].o1.thrust == MAX_THRUST) {
+            bool shieldUsed = false;
+            for(int i = 0; i < TURNS; i++) {
+                if(solution[TURNS].o1.shieldEnabled) {
+                    shieldUsed = true;
+                    break;
+                }
+            }
+            if(!shieldUsed) {
+                static constexpr float minimumDistFactor = 0.7f;
+                static constexpr float boostAngleLimit = M_PI * (5.0f / 180.0f);
+                float distThreshold = gameState.race->maxCheckpointDist * minimumDistFactor;
+                if(Vector::dist(race->checkpoints[racer.nextCheckpoint], racer.pos) > distThreshold) {
+                    if(abs(physics.turnAngle(racer, race->checkpoints[racer.nextCheckpoint]) < boostAngleLimit)) {
+                        solution[0].o1.boostEnabled = true;
+                    }
+                }
+            }
+        }
+        // Bouncer
+        if(gameState.ourState().pods[1].boostAvailable) {
+            if(!solution[0].o2.shieldEnabled && solution[0].o2.thrust == MAX_THRUST && solution[1].o2.shieldEnabled) {
+                if(Vector::distSq(bouncer.pos, enemyRacer.pos) < 3000*3000) {
+                    static constexpr float boostAngleLimit = M_PI * (5.0f / 180.0f);
+                    if (abs(physics.turnAngle(bouncer, enemyRacer.pos) < boostAngleLimit) &&
+                        abs(physics.turnAngle(enemyRacer, bouncer.pos)) < 2 * boostAngleLimit) {
+                        solution[0].o2.boostEnabled = true;
+                    }
+                }
+            }
+        }
+        if (switched) {
+            PodOutputSim temp;
+            for(int i = 0; i < TURNS; i++) {
+                temp = solution[i].o1;
+                solution[i].o1 = solution[i].o2;
+                solution[i].o2 = temp;
+            }
+        }
+        return solution[0];
+    }
+
+    float progress(const PodState *pod, const PodState *previous);
+
+    float bouncerScore(const PodState *bouncer, const PodState *target, const PodState *targetPrev);
+};
+
+
+template<int TURNS>
+PairOutput SearchBot<TURNS>::random() {
+    int randomSpeed = rng.nextInt(MAX_THRUST + 1);
+    float randomAngle = Physics::degreesToRad(-18 + rng.nextInt(MAX_ANGLE_DEG * 2 + 1));
+    bool shieldEnabled = false;
+    PodOutputSim o1(randomSpeed, randomAngle, shieldEnabled, false);
+
+    randomSpeed = rng.nextInt(MAX_THRUST + 1);
+    randomAngle = Physics::degreesToRad(-18 + rng.nextInt(MAX_ANGLE_DEG * 2 + 1));
+    PodOutputSim o2(randomSpeed, randomAngle, shieldEnabled, false);
+    return PairOutput(o1, o2);
+}
+
+template<int TURNS>
+void SearchBot<TURNS>::randomEdit(PairOutput& po) {
+    PROFILE_SCOPE(RANDOM_EDIT);
+    float sw = rng.nextFloat();
+    // No edit uses this second draw any more; it is kept so that seeded searches still edit the same way.
+    rng.nextFloat();
+    if(sw < 5.0/32.0) {
+        po.o1.thrust = max(0, min(MAX_THRUST, (rng.nextInt(400 + 1) - 100)));
+        po.o1.shieldEnabled = false;
+    } else if(sw < 10.0/32.0) {
+        po.o2.thrust = max(0, min(MAX_THRUST, (rng.nextInt(600 + 1) - 200)));
+        po.o2.shieldEnabled = false;
+    } else if(sw < 20.0/32.0) {
+        po.o1.angle = max(-MAX_ANGLE, min(MAX_ANGLE, physics.degreesToRad(-25 + rng.nextInt(50 + 1))));
+    } else if(sw < 30.0/32.0) {
+        po.o2.angle = max(-MAX_ANGLE, min(MAX_ANGLE, physics.degreesToRad(-25 + rng.nextInt(50 + 1))));
+    } else if(sw < 31.0/32.0) {
+        po.o1.shieldEnabled = true;
+        po.o1.thrust = 0;
+    } else if(sw < 1.0) {
+        po.o2.shieldEnabled = true;
+        po.o2.thrust = 0;
+    }
+}
+
+template<int TURNS>
+void SearchBot<TURNS>::randomSolution(PairOutput sol[]) {
+    for(int i = 0; i < TURNS; i++) {
+        sol[i] = random();
+    }
+}
+
+
+template<int TURNS>
+float SearchBot<TURNS>::score(const PairOutput solution[], int startFromTurn, int editedPod) {
+    PROFILE_SCOPE(SCORE);
+    if(editedPod != -1) {
+        startFromTurn = resimulatePod(solution, startFromTurn, editedPod);
+    }
+    if(startFromTurn < TURNS) {
+        CustomAI customAI(solution, startFromTurn);
+        enemyBot->setTurn(startFromTurn);
+        simulate(&customAI, enemyBot, TURNS, startFromTurn);
+    }
+    const PodState* ourPods[] = {&ourSimHistory[TURNS][0], &ourSimHistory[TURNS][1]};
+    if(tailTurns > 0) {
+        simulateTail();
+        ourPods[0] = &racerTail;
+    }
+    const PodState* ourPodsPrev[] = {&ourSimHistory[0][0], &ourSimHistory[0][1]};
+    const PodState* enemyPods[] = {&enemySimHistory[TURNS][0], &enemySimHistory[TURNS][1]};
+    const PodState* enemyPodsPrev[] = {&enemySimHistory[0][0], &enemySimHistory[0][1]};
+    return score(ourPods, ourPodsPrev, enemyPods, enemyPodsPrev);
+}
+
+template<int TURNS>
+float SearchBot<TURNS>::score(const PodState* pods[], const PodState* podsPrev[], const PodState* enemyPods[], const PodState* enemyPodsPrev[]) {
+    const int totalCPs = race->totalCPCount();
+
+    if(pods[0]->passedCheckpoints == totalCPs) {
+        for(int i = 1; i <= TURNS; i++) {
+            if(ourSimHistory[0][i].passedCheckpoints == totalCPs) {
+                return minScore + i * 5000;
+            }
+        }
+    }
+    if(enemyPods[0]->passedCheckpoints == totalCPs) {
+        for(int i = 1; i <= TURNS; i++) {
+            if(enemySimHistory[0][i].passedCheckpoints == totalCPs) {
+                return maxScore  - i * 5000;
+            }
+        }
+    }
+    if(pods[0]->turnsSinceCP >= WANDER_TIMEOUT && pods[1]->turnsSinceCP >= WANDER_TIMEOUT) {
+        return maxScore;
+    }
+    if(enemyPods[0]->turnsSinceCP >= WANDER_TIMEOUT && enemyPods[1]->turnsSinceCP >= WANDER_TIMEOUT) {
+        return minScore;
+    }
+
+    // Racer
+    float racerScore = progress(pods[0], podsPrev[0]);
+    float chaserScore = 0;
+    if(min(enemyPodsPrev[0]->turnsSinceCP, enemyPodsPrev[1]->turnsSinceCP) < podsPrev[0]->turnsSinceCP && podsPrev[0]->turnsSinceCP > 50 + TURNS && enemyPods[0]->passedCheckpoints < race->totalCPCount() - 1) {
+        chaserScore -=  0.6*Vector::dist(pods[0]->pos, pods[1]->pos);
+        chaserScore += 0.4*Vector::dist(enemyPods[1]->pos, pods[0]->pos);
+        chaserScore += 0.2*Vector::dist(enemyPods[0]->pos, pods[0]->pos);
+    } else {
+        chaserScore = bouncerScore(pods[1], enemyPods[0], enemyPodsPrev[0]);
+        racerScore += sFactors.enemyProgress*progress(enemyPods[0], enemyPodsPrev[0]);
+    }
+    int startCP = podsPrev[0]->nextCheckpoint;
+    if(Vector::distSq(enemyPodsPrev[1]->pos, race->checkpoints[startCP]) < Vector::distSq(podsPrev[0]->pos, race->checkpoints[startCP]) && Vector::distSq(enemyPodsPrev[1]->pos, podsPrev[0]->pos) < 3000*3000) {
+        for(int i = 0; i < TURNS; i++) {
+            if(ourSimHistory[i+1][0].nextCheckpoint != startCP || Vector::distSq(enemySimHistory[i+1][1].pos, race->checkpoints[startCP]) > Vector::distSq(ourSimHistory[i+1][0].pos, race->checkpoints[startCP])+400) {
+                racerScore += sFactors.skirtBonus * (TURNS - i);
+                break;
+            }
+        }
+    }
+    float score = 200000-(racerScore*sFactors.overallRacer + chaserScore*sFactors.overallBouncer);
+    return score;
+}
+
+template<int TURNS>
+float SearchBot<TURNS>::progress(const PodState* pod, const PodState* previous) {
+    // Range: [0, 20000]
+    static const int PASS_CP_BONUS = sFactors.passCPBonus;
+    int ourNextCPID = pod->nextCheckpoint;
+    int ourCurCPID = previous->nextCheckpoint;
+    Vector ourNextCP = race->checkpoints[ourNextCPID];
+    Vector ourCurCP = race->checkpoints[ourCurCPID];
+    float progress = -Vector::dist(pod->pos, race->checkpoints[pod->nextCheckpoint]) + 20000 * (pod->passedCheckpoints - previous->passedCheckpoints);
+    for(int i = 0; i < TURNS; i++) {
+        if(ourSimHistory[i+1][0].nextCheckpoint != ourSimHistory[i][0].nextCheckpoint) {
+            progress += sFactors.passCPBonus;
+            progress += sFactors.earlyPassBonus * (TURNS - i);
+        }
+    }
+    progress -= max(0, TURNS -pod->turnsSinceShield)*sFactors.shieldPenalty;
+    return progress;
+}
+
+
+static constexpr float MAX_DIST = 30000.0f;
+
+template<int TURNS>
+float SearchBot<TURNS>::bouncerScore(const PodState *bouncer, const PodState *target, const PodState *targetPrev) {
+    float score = 0;
+    int targetCP = target->nextCheckpoint;
+    bool next = false;
+    if(targetPrev->passedCheckpoints != race->totalCPCount() -1 && Vector::dist(ourSimHistory[0][1].pos, race->checkpoints[targetPrev->nextCheckpoint]) > Vector::dist(targetPrev->pos, race->checkpoints[targetPrev->nextCheckpoint]) + 500) {
+        targetCP = race->followingCheckpoint(targetPrev->nextCheckpoint);
+        next = true;
+    }
+    Vector enemyCPDiff = target->pos - race->checkpoints[targetCP];
+    Vector bouncerCPDiff = bouncer->pos - race->checkpoints[targetCP];
+    Vector enemyBouncerDiff = bouncer->pos - target->pos;
+    static const int TOO_CLOSE = 50;
+    float angleSeenByCP = bouncerCPDiff.getLength() <= TOO_CLOSE ? 0 : 637.0f * (abs(physics.angleBetween(enemyCPDiff, bouncerCPDiff)) - M_PI/2.0f);
+    float angleSeenByEnemy = bouncerCPDiff.getLength() <= TOO_CLOSE ? 0 : 637.0f * (abs(physics.angleBetween(race->checkpoints[targetCP] - target->pos, bouncer->pos - target->pos)) - M_PI/2.0f);
+    float bouncerTurnAngle = 637.0f * (abs(physics.turnAngle(*bouncer, target->pos)) - M_PI/2.0f);
+    float enemyTurnAngle = 637.0f * (abs(physics.turnAngle(*target, bouncer->pos)) - M_PI/2.0f);
+    float checkpointPenalty = target->passedCheckpoints > targetPrev->passedCheckpoints ? 1 : 0;
+
+    score += sFactors.bouncerDistToCP * (-4000 + min(MAX_DIST, bouncerCPDiff.getLength())) +
+            sFactors.bouncerTurnAngle * bouncerTurnAngle;
+    score += max(0, TURNS-bouncer->turnsSinceShield) * sFactors.shieldPenalty;
+
+    if(!next) {
+        score += sFactors.enemyDistToCP * (-4000 + min(MAX_DIST, enemyCPDiff.getLength())) +
+                 sFactors.angleSeenByCP * angleSeenByCP +
+                 sFactors.angleSeenByEnemy * angleSeenByEnemy +
+                 sFactors.enemyTurnAngle * enemyTurnAngle +
+                 sFactors.enemyDist * (-3000 + min(MAX_DIST, enemyBouncerDiff.getLength())) +
+                 sFactors.checkpointPenalty * checkpointPenalty;
+    }
+
+    return score;
+}
+
+
+template<int TURNS>
+void SearchBot<TURNS>::simulate(SimBot* pods1Sim, SimBot* pods2Sim, int turns, int startFromTurn) {
+    PodState* allPods[POD_COUNT*2] = {&ourSimHistory[startFromTurn][0], &ourSimHistory[startFromTurn][1],
+                                      &enemySimHistory[startFromTurn][0], &enemySimHistory[startFromTurn][1]};
+    // Pairs of pods too far apart to meet before the end of the rollout are never tested.
+    int culledPairs = physics.cullPairs(allPods, turns - startFromTurn);
+    for(int i = startFromTurn; i < turns; i++) {
+        memcpy(ourSimHistory[i+1], ourSimHistory[i], POD_COUNT*sizeof(PodState));
+        memcpy(enemySimHistory[i+1], enemySimHistory[i], POD_COUNT*sizeof(PodState));
+        allPods[0] = &ourSimHistory[i+1][0];
+        allPods[1] = &ourSimHistory[i+1][1];
+        allPods[2] = &enemySimHistory[i+1][0];
+        allPods[3] = &enemySimHistory[i+1][1];
+        pods1Sim->move(ourSimHistory[i+1], enemySimHistory[i]);
+        pods2Sim->move(enemySimHistory[i+1], ourSimHistory[i]);
+        enemyControlled[i][0] = enemySimHistory[i+1][0];
+        enemyControlled[i][1] = enemySimHistory[i+1][1];
+        physics.simulate(allPods, culledPairs, &turnLogs[i]);
+    }
+}
+
+template<int TURNS>
+void SearchBot<TURNS>::simulateTail() {
+    PROFILE_SCOPE(TAIL);
+    racerTail = ourSimHistory[TURNS][0];
+    for(int t = 0; t < tailTurns; t++) {
+        Physics::apply(racerTail, policyBot.racerOutput(&racerTail));
+        physics.simulateSolo(racerTail);
+    }
+    racerTail.turnsSinceShield = ourSimHistory[TURNS][0].turnsSinceShield;
+}
+
+template<int TURNS>
+int SearchBot<TURNS>::resimulatePod(const PairOutput solution[], int fromTurn, int podIdx) {
+    bool readsPod = ((enemyBot->opponentPodsRead(0) | enemyBot->opponentPodsRead(1)) >> podIdx) & 1;
+    for(int i = fromTurn; i < TURNS; i++) {
+        PodState pod = ourSimHistory[i][podIdx];
+        Physics::apply(pod, podIdx == 0 ? solution[i].o1 : solution[i].o2);
+        // If the opponent looks at our pod, check its controls come out the same. On the first turn our pod
+        // hasn't moved yet, so they do.
+        if(i > fromTurn && readsPod) {
+            PodState enemyPods[POD_COUNT] = {enemySimHistory[i][0], enemySimHistory[i][1]};
+            enemyBot->setTurn(i);
+            enemyBot->move(enemyPods, ourSimHistory[i]);
+            if(!sameControlled(enemyPods[0], enemyControlled[i][0]) ||
+               !sameControlled(enemyPods[1], enemyControlled[i][1])) {
+                return i;
+            }
+        }
+        if(!physics.simulateAlone(pod, podIdx, turnLogs[i])) {
+            return i;
+        }
+        ourSimHistory[i+1][podIdx] = pod;
+    }
+    return TURNS;
+}
+
+template<int TURNS>
+void SearchBot<TURNS>::saveRollout(int fromTurn) {
+    int turns = TURNS - fromTurn;
+    memcpy(savedOurHistory[fromTurn + 1], ourSimHistory[fromTurn + 1], turns * sizeof(ourSimHistory[0]));
+    memcpy(savedEnemyHistory[fromTurn + 1], enemySimHistory[fromTurn + 1], turns * sizeof(enemySimHistory[0]));
+    memcpy(savedEnemyControlled[fromTurn], enemyControlled[fromTurn], turns * sizeof(enemyControlled[0]));
+    memcpy(&savedTurnLogs[fromTurn], &turnLogs[fromTurn], turns * sizeof(TurnLog));
+}
+
+template<int TURNS>
+void SearchBot<TURNS>::restoreRollout(int fromTurn) {
+    int turns = TURNS - fromTurn;
+    memcpy(ourSimHistory[fromTurn + 1], savedOurHistory[fromTurn + 1], turns * sizeof(ourSimHistory[0]));
+    memcpy(enemySimHistory[fromTurn + 1], savedEnemyHistory[fromTurn + 1], turns * sizeof(enemySimHistory[0]));
+    memcpy(enemyControlled[fromTurn], savedEnemyControlled[fromTurn], turns * sizeof(enemyControlled[0]));
+    memcpy(&turnLogs[fromTurn], &savedTurnLogs[fromTurn], turns * sizeof(TurnLog));
+}
+
+template<int TURNS>
+int SearchBot<TURNS>::editedPod(const PairOutput& before, const PairOutput& after) {
+    bool sameO1 = sameOutput(before.o1, after.o1);
+    bool sameO2 = sameOutput(before.o2, after.o2);
+    if(sameO1 == sameO2) return -1;
+    return sameO1 ? 1 : 0;
+}
+
+#endif //CODERSSTRIKEBACK_SEARCHBOT_H
@@ -0,0 +1,54 @@
+#ifndef CODERSSTRIKEBACK_SEARCHBUDGET_H
+#define CODERSSTRIKEBACK_SEARCHBUDGET_H
+
+/**
+ * How much work a search may do for one move.
+ *
+ * A time budget is what the live bot needs, but how much search it buys depends on the machine and its load. Rollout
+ * and cooling step budgets fix the amount of search instead, so with a fixed seed the result is the same however many
+ * other threads are running.
+ */
+struct SearchBudget {
+    enum Kind {
+        // No budget given; the search uses its own fixed schedule.
+        UNSET,
+        // Milliseconds of wall-clock time.
+        TIME,
+        // Number of candidate solutions scored.
+        ROLLOUTS,
+        // Number of temperature steps, each with a proportional number of rollouts.
+        COOLING_STEPS
+    };
+
+    Kind kind = UNSET;
+    long amount = 0;
+
+    SearchBudget() {}
+
+    SearchBudget(Kind kind, long amount) : kind(kind), amount(amount) {}
+
+    static SearchBudget time(long milliseconds) {
+        return SearchBudget(TIME, milliseconds);
+    }
+
+    static SearchBudget rollouts(long count) {
+        return SearchBudget(ROLLOUTS, count);
+    }
+
+    static SearchBudget coolingSteps(long count) {
+        return SearchBudget(COOLING_STEPS, count);
+    }
+
+    bool isTimed() const {
+        return kind == TIME;
+    }
+
+    /**
+     * True if the amount of search done does not depend on how fast it runs.
+     */
+    bool isDeterministic() const {
+        return kind != TIME;
+    }
+};
+
+#endif //CODERSSTRIKEBACK_SEARCHBUDGET_H
@@ -3,7 +3,11 @@
 
 #include "State.h"
 #include "AnnealingBot.h"
+#include "EditScreen.h"
+#include "EndgameSolver.h"
+#include "GeneticBot.h"
 #include "Physics.h"
+#include "Replay.h"
 #include "json.hpp"
 
 using json = nlohmann::json;
@@ -16,7 +20,18 @@ public:
     vector<PodState> player2Pod1;
     vector<PodState> player2Pod2;
 
-    GameHistory(vector<Vector> checkpoints) : checkpoints(checkpoints){};
+    GameHistory(const CheckpointList& checkpoints) : checkpoints(checkpoints.begin(), checkpoints.end()){};
+
+    // Load a binary replay, e.g. to convert it to JSON for the visualizer.
+    static GameHistory fromReplay(const ReplayReader& reader) {
+        GameHistory history(reader.race().checkpoints);
+        for(int i = 0; i < reader.turnCount(); i++) {
+            const replay::TurnRecord& t = reader.turn(i);
+            history.recordTurn(replay::unpack(t.pods[0]), replay::unpack(t.pods[1]),
+                               replay::unpack(t.pods[2]), replay::unpack(t.pods[3]));
+        }
+        return history;
+    }
 
     void recordTurn(PodState p11, PodState p12, PodState p21, PodState p22) {
         player1Pod1.push_back(p11);
@@ -65,27 +80,122 @@ public:
 };
 
 
+/**
+ * One player in self-play, kept alive for the whole game as the live bot is (see main.cpp). Each turn, a short search
+ * models the opponent, and the main bot searches against that model. Both warm-start from the previous turn's
+ * solution, and nothing is allocated after construction.
+ *
+ * The main bot can be any SearchBot; the opponent model is always annealed, so that players with different main bots
+ * only differ in that.
+ */
+template<int TURNS, template<int> class Searcher = AnnealingBot>
+class SelfPlayer : public DuelBot {
+    PairOutput opponentSolution[TURNS - 1];
+    PodState opponentExpected[TURNS - 1][POD_COUNT];
+    CustomAIWithBackup<TURNS - 1> opponentAI;
+    RacingLines lines;
+    Physics physics;
+    EndgameSolver endgame;
+    EditScreen modelScreen;
+    EditScreen botScreen;
+
+    /**
+     * Which of our pods, in input order, has a plan from EndgameSolver, or -1. Only the lead pod is tried, on its last
+     * checkpoint and when nobody can get in its way.
+     */
+    int solveEndgame(GameState& gameState, EndgameSolver::Plan& plan) {
+        PodState ourPods[POD_COUNT] = {gameState.ourState().pods[0], gameState.ourState().pods[1]};
+        bool switched = physics.orderByProgress(ourPods);
+        if(!endgame.applies(ourPods[0])) return -1;
+        PodState others[] = {ourPods[1], gameState.enemyState().pods[0], gameState.enemyState().pods[1]};
+        return endgame.solve(ourPods[0], others, 3, plan) ? switched : -1;
+    }
+
+public:
+    AnnealingBot<TURNS - 1> opponentModel;
+    Searcher<TURNS> bot;
+    // Have the lead pod follow EndgameSolver's plan instead of the search's. Off: the solver gives up whenever a pod
+    // could interfere, which is when the endgame is hard, and it hasn't yet won a game the search would lose.
+    bool useEndgameSolver = false;
+
+    SelfPlayer(RaceRef race, SearchBudget modelBudget, SearchBudget botBudget) :
+            opponentAI(race, opponentSolution, opponentExpected, 0),
+            lines(race),
+            physics(race),
+            endgame(race),
+            opponentModel(race, modelBudget),
+            bot(race, botBudget, &opponentAI) {
+        opponentAI.setDefaultAfter(TURNS - 1);
+        opponentModel.setRacingLines(&lines);
+        bot.setRacingLines(&lines);
+    }
+
+    SelfPlayer(const SelfPlayer&) = delete;
+    SelfPlayer& operator=(const SelfPlayer&) = delete;
+
+    void seed(uint64_t modelSeed, uint64_t botSeed) {
+        opponentModel.seed(modelSeed);
+        bot.seed(botSeed);
+    }
+
+    PairOutput move(GameState& gameState) {
+        // Before the searches, so that the time it takes comes out of their budgets.
+        EndgameSolver::Plan plan;
+        int endgamePod = useEndgameSolver ? solveEndgame(gameState, plan) : -1;
+        opponentModel.train(gameState.enemyState().pods, gameState.ourState().pods, opponentSolution,
+                            opponentExpected[0]);
+        opponentAI.reset();
+        PairOutput output = bot.move(gameState);
+        // The plan includes its own boost.
+        if(endgamePod == 0) {
+            output.o1 = plan.first;
+        } else if(endgamePod == 1) {
+            output.o2 = plan.first;
+        }
+        return output;
+    }
+
+    /**
+     * Rollouts used by both searches on the last move.
+     */
+    int rolloutCount() const {
+        return opponentModel.rolloutCount() + bot.rolloutCount();
+    }
+
+    /**
+     * Have both searches screen their edits (see EditScreen). The main bot must be annealed.
+     */
+    void useEditScreens() {
+        opponentModel.editScreen = &modelScreen;
+        bot.editScreen = &botScreen;
+    }
+
+    /**
+     * How the edit screens of both searches did on the last move. Empty unless useEditScreens() was called.
+     */
+    EditScreen::Stats screenStats() const {
+        EditScreen::Stats stats = modelScreen.stats();
+        stats += botScreen.stats();
+        return stats;
+    }
+
+    /**
+     * How often the score caches of both searches were hit on the last move.
+     */
+    ScoreCache::Stats cacheStats() const {
+        ScoreCache::Stats stats = opponentModel.cacheStats();
+        stats += bot.cacheStats();
+        return stats;
+    }
+};
+
 class Simulation {
+    // Owned here, and shared by pointer with the physics and bots of each game.
     Race race;
-    Physics physics;
 
-    // Place pods along a line at checkpoint 0 facing checkpoint 1.
-    void initializePods(PodState aPods[], PodState bPods[]) {
-        Vector facingDirection = race.checkpoints[1] - race.checkpoints[0];
-        Vector startLine = facingDirection.tanget().normalize();
-        float gap = POD_RADIUS + 100;
-        Vector posA1 = race.checkpoints[0] + startLine * gap;
-        Vector posA2 = race.checkpoints[0] - startLine * gap;
-        Vector posB1 = race.checkpoints[0] +  startLine * 3 * gap;
-        Vector posB2 = race.checkpoints[0] - startLine * 3 * gap;
-        float angle = Physics::angleTo(posA1, race.checkpoints[1]);
-        aPods[0] = PodState(posA1, Vector(0,0), angle, 1);
-        angle = Physics::angleTo(posA2, race.checkpoints[1]);
-        aPods[1] = PodState(posA2, Vector(0,0), angle, 1);
-        angle = Physics::angleTo(posB1, race.checkpoints[1]);
-        bPods[0] = PodState(posB1, Vector(0,0), angle, 1);
-        angle = Physics::angleTo(posB2, race.checkpoints[1]);
-        bPods[1] = PodState(posB2, Vector(0,0), angle, 1);
+    // Bound on use rather than stored, so that copies of a Simulation don't point at another's race.
+    Physics physics() const {
+        return Physics(race);
     }
 
     bool victory(PodState ourPods[], PodState enemyPods[]) {
@@ -114,79 +224,119 @@ class Simulation {
         basic.pos.x = (int)round(podState.pos.x);
         basic.pos.y = (int)round(podState.pos.y);
         basic.nextCheckpoint = podState.nextCheckpoint;
-        basic.angle = physics.degreesToRad(round(physics.radToDegrees(podState.angle)));
+        basic.angle = Physics::degreesToRad(round(Physics::radToDegrees(podState.angle)));
         return basic;
     }
 
 public:
     GameHistory history;
     static const int TURN_LIMIT = 250;
-    Simulation(Race r) : race(r), physics(r), history(r.checkpoints){}
+    // Every bot's random stream is derived from this seed, its role and the turn. Two games with the same seed and
+    // race give their bots identical random streams (common random numbers), whatever the bots' score factors.
+    uint64_t seed = 0;
+    // When set, every turn is streamed to this replay (see Replay.h). Unlike history, nothing is buffered here.
+    ReplayWriter* recorder = nullptr;
+    // Search budgets of each player's opponent model and main bot. Rollout budgets make a game depend only on the
+    // seed, not on how busy the machine is; they're about what the time budgets of the live bot buy on one core.
+    SearchBudget modelBudget = SearchBudget::rollouts(14000);
+    SearchBudget botBudget = SearchBudget::rollouts(40000);
+    // SearchBot::tailTurns and useScoreCache of every search in fullGameParamSim(), and whether they screen their edits
+    // (see SelfPlayer::useEditScreens()).
+    int tailTurns = 0;
+    bool useEditScreen = false;
+    bool useScoreCache = true;
+    // SelfPlayer::useEndgameSolver of player B, the one under test, in fullGameParamSim().
+    bool useEndgameSolver = false;
+    // Totals over every game played by this simulation.
+    long turnsPlayed = 0;
+    long rollouts = 0;
+    EditScreen::Stats screenStats;
+    ScoreCache::Stats cacheStats;
+    Simulation(const Race& r) : race(r), history(r.checkpoints){}
+    Simulation(const Race& r, uint64_t seed) : race(r), history(r.checkpoints), seed(seed) {}
+
+    // Place pods along a line at checkpoint 0 facing checkpoint 1.
+    void initializePods(PodState aPods[], PodState bPods[]) {
+        Vector facingDirection = race.checkpoints[1] - race.checkpoints[0];
+        Vector startLine = facingDirection.tanget().normalize();
+        float gap = POD_RADIUS + 100;
+        Vector posA1 = race.checkpoints[0] + startLine * gap;
+        Vector posA2 = race.checkpoints[0] - startLine * gap;
+        Vector posB1 = race.checkpoints[0] +  startLine * 3 * gap;
+        Vector posB2 = race.checkpoints[0] - startLine * 3 * gap;
+        float angle = Physics::angleTo(posA1, race.checkpoints[1]);
+        aPods[0] = PodState(posA1, Vector(0,0), angle, 1);
+        angle = Physics::angleTo(posA2, race.checkpoints[1]);
+        aPods[1] = PodState(posA2, Vector(0,0), angle, 1);
+        angle = Physics::angleTo(posB1, race.checkpoints[1]);
+        bPods[0] = PodState(posB1, Vector(0,0), angle, 1);
+        angle = Physics::angleTo(posB2, race.checkpoints[1]);
+        bPods[1] = PodState(posB2, Vector(0,0), angle, 1);
+    }
+
+    void recordTo(ReplayWriter* replayWriter) {
+        recorder = replayWriter;
+    }
+
+    const Race& getRace() const {
+        return race;
+    }
 
     int parameterSim(PodState aPods[], PodState bPods[], ScoreFactors sFactors, bool printOut) {
         PodState* pods[] = {&aPods[0], &aPods[1], &bPods[0], &bPods[1]};
+        // Player A only races, player B only bounces. B's bouncer uses the factors under test.
+        SelfPlayer<6> aPlayer(race, modelBudget, botBudget);
+        aPlayer.opponentModel.sFactors.overallRacer = 0;
+        aPlayer.bot.sFactors.overallBouncer = 0;
+        SelfPlayer<6> bPlayer(race, modelBudget, botBudget);
+        bPlayer.opponentModel.sFactors.overallBouncer = 0;
+        bPlayer.bot.sFactors = sFactors;
+        bPlayer.bot.sFactors.overallRacer = 0;
         for(int i = 0; i < TURN_LIMIT; i++) {
             if(printOut) {
                 history.recordTurn(*pods[0], *pods[1], *pods[2], *pods[3]);
             }
             // If game over (by aPods victory), return the number of turns.
             if (aPods[0].passedCheckpoints == race.totalCPCount()) {
+                if(recorder) recorder->writeTurn(pods);
                 return i;
             }
             // Setup game data.
             PlayerState forA[PLAYER_COUNT] = {PlayerState(aPods), PlayerState(bPods)};
             PlayerState forB[PLAYER_COUNT] = {PlayerState(bPods), PlayerState(aPods)};
-            int turn = i+1; // skip first turn to avoid initialization which will reset out fake setup.
+            // Skip the first turn to avoid initialization, which would reset our fake setup.
             GameState aGS(race, forA, i+1);
             GameState bGS(race, forB, i+1);
 
-            // Train pod 1
-            PairOutput bouncerSolution[5];
-            AnnealingBot<5> bouncerBotFake(race, 40);
-            bouncerBotFake.sFactors.overallRacer = 0;
-            PodState stateExpected[5][2];
-            bouncerBotFake.train(aGS.enemyState().pods, aGS.ourState().pods, bouncerSolution, stateExpected[0]);
-            CustomAIWithBackup<5> bouncerAI(race, bouncerSolution, stateExpected, 0);
-            bouncerAI.setDefaultAfter(5);
-            AnnealingBot<6> racerBot(race, 80, &bouncerAI);
-            // Disable bouncer.
-            racerBot.sFactors.overallBouncer = 0;
-
-            // Train pod 2
-            PairOutput racerSolution[5];
-            AnnealingBot<5> racerBotFake(race, 40);
-            racerBotFake.sFactors.overallBouncer = 0;
-            PodState stateExpected2[5][2];
-            racerBotFake.train(bGS.enemyState().pods, bGS.ourState().pods, racerSolution, stateExpected[0]);
-            CustomAIWithBackup<5> racerAI(race, racerSolution, stateExpected2, 0);
-            racerAI.setDefaultAfter(5);
-            AnnealingBot<6> bouncerBot(race, 80, &racerAI);
-            bouncerBot.sFactors = sFactors;
-            // Disable racer.
-            bouncerBot.sFactors.overallRacer = 0;
+            aPlayer.seed(Random::mix(seed, i, 0), Random::mix(seed, i, 1));
+            bPlayer.seed(Random::mix(seed, i, 2), Random::mix(seed, i, 3));
 
             // Play the turn.
-            PairOutput aOut = racerBot.move(aGS);
-            PairOutput bOut = bouncerBot.move(bGS);
-            physics.apply(aPods, aOut);
-            physics.apply(bPods, bOut);
-            physics.simulate(pods);
+            PairOutput aOut = aPlayer.move(aGS);
+            PairOutput bOut = bPlayer.move(bGS);
+            turnsPlayed++;
+            rollouts += aPlayer.rolloutCount() + bPlayer.rolloutCount();
+            if(recorder) recorder->writeTurn(pods, &aOut, &bOut);
+            Physics::apply(aPods, aOut);
+            Physics::apply(bPods, bOut);
+            physics().simulate(pods);
         }
+        if(recorder) recorder->writeTurn(pods);
         return TURN_LIMIT;
     }
 
 
 
     float progressDiff(PodState aPods[], PodState bPods[]) {
-        int aLead = physics.leadPodID(aPods);
-        int bLead = physics.leadPodID(bPods);
+        int aLead = physics().leadPodID(aPods);
+        int bLead = physics().leadPodID(bPods);
         float aProgress = progress(aPods[aLead]);
         float bProgress = progress(bPods[bLead]);
         return aProgress - bProgress;
     }
 
     float checkpointsToGo(PodState winner[]) {
-        int lead = physics.leadPodID(winner);
+        int lead = physics().leadPodID(winner);
         return race.totalCPCount() - winner[lead].passedCheckpoints;
     }
 
@@ -208,6 +358,31 @@ public:
     static const int SCORE_LIMIT =   1000000;
     static const int EARLY_VICTORY_BONUS = 1000;
     double fullGameParamSim(ScoreFactors sFactors, bool printOut) {
+        // Player A uses the default factors, player B the factors under test.
+        SelfPlayer<6> aPlayer(race, modelBudget, botBudget);
+        SelfPlayer<6> bPlayer(race, modelBudget, botBudget);
+        bPlayer.opponentModel.sFactors = sFactors;
+        bPlayer.bot.sFactors = sFactors;
+        aPlayer.opponentModel.tailTurns = aPlayer.bot.tailTurns = tailTurns;
+        bPlayer.opponentModel.tailTurns = bPlayer.bot.tailTurns = tailTurns;
+        if(useEditScreen) {
+            aPlayer.useEditScreens();
+            bPlayer.useEditScreens();
+        }
+        aPlayer.opponentModel.useScoreCache = aPlayer.bot.useScoreCache = useScoreCache;
+        bPlayer.opponentModel.useScoreCache = bPlayer.bot.useScoreCache = useScoreCache;
+        bPlayer.useEndgameSolver = useEndgameSolver;
+        return fullGame(aPlayer, bPlayer, printOut);
+    }
+
+    /**
+     * Play a whole game between two self-players (see SelfPlayer), e.g. with different search bots.
+     *
+     * @return player B's progress over player A's, with a bonus for each checkpoint the loser had left if the game
+     * ended early.
+     */
+    template<typename PlayerA, typename PlayerB>
+    double fullGame(PlayerA& aPlayer, PlayerB& bPlayer, bool printOut) {
         PodState aPods[POD_COUNT];
         PodState bPods[POD_COUNT];
         initializePods(aPods, bPods);
@@ -228,44 +403,33 @@ public:
                     cerr << "Score limit reached at: " << score << endl;
                     score = 0;
                 }
+                if(recorder) recorder->writeTurn(pods);
                 return score;
             }
 
             // Setup game data.
             PlayerState forA[PLAYER_COUNT] = {PlayerState(aPods), PlayerState(bPods)};
             PlayerState forB[PLAYER_COUNT] = {PlayerState(bPods), PlayerState(aPods)};
-            int turn = i+1; // skip first turn to avoid initialization which will reset out fake setup.
+            // Skip the first turn to avoid initialization, which would reset our fake setup.
             GameState aGS(race, forA, i+1);
             GameState bGS(race, forB, i+1);
 
-            // Train pod 1
-            PairOutput bouncerSolution[5];
-            AnnealingBot<5> bouncerBotFake(race, 25);
-//            bouncerBotFake.isControl = true;
-            PodState stateExpected[5][2];
-            bouncerBotFake.train(aGS.enemyState().pods, aGS.ourState().pods, bouncerSolution, stateExpected[0]);
-            CustomAIWithBackup<5> bouncerAI(race, bouncerSolution, stateExpected, 0);
-            bouncerAI.setDefaultAfter(5);
-            AnnealingBot<6> racerBot(race, 70, &bouncerAI);
-//            racerBot.isControl = true;
-
-            // Train pod 2
-            PairOutput racerSolution[5];
-            AnnealingBot<5> racerBotFake(race, 25);
-            racerBotFake.sFactors = sFactors;
-            PodState stateExpected2[5][2];
-            racerBotFake.train(bGS.enemyState().pods, bGS.ourState().pods, racerSolution, stateExpected2[0]);
-            CustomAIWithBackup<5> racerAI(race, racerSolution, stateExpected2, 0);
-            racerAI.setDefaultAfter(5);
-            AnnealingBot<6> bouncerBot(race, 70, &racerAI);
-            bouncerBot.sFactors = sFactors;
+            aPlayer.seed(Random::mix(seed, i, 0), Random::mix(seed, i, 1));
+            bPlayer.seed(Random::mix(seed, i, 2), Random::mix(seed, i, 3));
 
             // Play the turn.
-            PairOutput aOut = racerBot.move(aGS);
-            PairOutput bOut = bouncerBot.move(bGS);
-            physics.apply(aPods, aOut);
-            physics.apply(bPods, bOut);
-            physics.simulate(pods);
+            PairOutput aOut = aPlayer.move(aGS);
+            PairOutput bOut = bPlayer.move(bGS);
+            turnsPlayed++;
+            rollouts += aPlayer.rolloutCount() + bPlayer.rolloutCount();
+            screenStats += aPlayer.screenStats();
+            screenStats += bPlayer.screenStats();
+            cacheStats += aPlayer.cacheStats();
+            cacheStats += bPlayer.cacheStats();
+            if(recorder) recorder->writeTurn(pods, &aOut, &bOut);
+            Physics::apply(aPods, aOut);
+            Physics::apply(bPods, bOut);
+            physics().simulate(pods);
         }
     }
 
@@ -280,12 +444,12 @@ public:
         State stateA(race);
         State stateB(race);
         for(int i = 0; i < TURN_LIMIT; i++) {
-            a = new AnnealingBot<6>(race, 140);
             history.recordTurn(*pods[0], *pods[1], *pods[2], *pods[3]);
 
             if (victory(aPods, bPods) || victory(bPods, aPods)) {
 //                cerr << "Finished. Winner is: bot #" << (victory(aPods, bPods) ? "1" : "2") << endl;
 //                cerr << "Victory on turn: " << i << endl;
+                if(recorder) recorder->writeTurn(pods);
                 return history;
             }
             PlayerState forA[PLAYER_COUNT];
@@ -296,16 +460,17 @@ public:
             stateB.preTurnUpdate(forB);
             PairOutput aOut = a->move(stateA.game());
             PairOutput bOut = b->move(stateB.game());
+            if(recorder) recorder->writeTurn(pods, &aOut, &bOut);
             stateA.postTurnUpdate( aOut.o1.absolute(stateA.game().ourState().pods[0]),
                     aOut.o2.absolute(stateA.game().ourState().pods[1]));
             stateB.postTurnUpdate( bOut.o1.absolute(stateB.game().ourState().pods[0]),
                     bOut.o2.absolute(stateB.game().ourState().pods[1]));
-            physics.apply(aPods, aOut);
-            physics.apply(bPods, bOut);
-            physics.simulate(pods);
+            Physics::apply(aPods, aOut);
+            Physics::apply(bPods, bOut);
+            physics().simulate(pods);
         }
+        if(recorder) recorder->writeTurn(pods);
         cout << "Game reached turn limit.";
-        delete(a);
         return history;
     }
 };
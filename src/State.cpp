@@ -47,18 +47,18 @@ void State::preTurnUpdate(PlayerState playerStates[]) {
             if(passed[0] == passed[1]) {
                 PodState& p0 = playerStates[i].pods[0];
                 PodState& p1 = playerStates[i].pods[1];
-                Vector& cp = race.checkpoints[p0.nextCheckpoint];
+                const Vector& cp = race->checkpoints[p0.nextCheckpoint];
                 playerStates[i].leadPodID = (cp - p0.pos).getLength() < (cp - p1.pos).getLength() ? 0 : 1;
             } else {
                 playerStates[i].leadPodID = passed[0] > passed[1] ? 0 : 1;
             }
         }
     }
-    current = GameState(race, playerStates, turn);
+    current = GameState(*race, playerStates, turn);
     if(turn == 0) {
         for(int i = 0; i < PLAYER_COUNT; i++) {
             for(int j= 0; j < POD_COUNT; j++) {
-                current.playerStates[i].pods[j].angle = Physics::angleTo(current.playerStates[i].pods[j].pos, race.checkpoints[1]);
+                current.playerStates[i].pods[j].angle = Physics::angleTo(current.playerStates[i].pods[j].pos, race->checkpoints[1]);
             }
         }
         // Get pod 0 to target enemy 0 so that there are no cross-overs in the path.
@@ -82,6 +82,13 @@ void State::update(const PodOutputAbs& pod, int id) {
     }
 }
 
+GameSnapshot State::save() const {
+    assert(turn > 0);
+    return previous.save();
+}
 
-
-
+void State::restore(const GameSnapshot& snapshot) {
+    previous.restore(*race, snapshot);
+    current = previous;
+    turn = snapshot.turn + 1;
+}
@@ -8,6 +8,10 @@
 #include <string>
 #include <cstring>
 #include <sstream>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
 
 #include "Vector.h"
 
@@ -29,46 +33,141 @@ static const int OUR_PLAYER_ID = 0;
 static const int BOOST_ACC = 650;
 
 
+static const int MAX_CHECKPOINTS = 8;
+
+/**
+ * A race's checkpoints, stored inline. Indexed and sized like the vector it replaced.
+ */
+struct CheckpointList {
+    Vector items[MAX_CHECKPOINTS];
+    int count = 0;
+
+    int size() const {
+        return count;
+    }
+
+    Vector& operator[](int i) {
+        return items[i];
+    }
+
+    const Vector& operator[](int i) const {
+        return items[i];
+    }
+
+    const Vector* begin() const {
+        return items;
+    }
+
+    const Vector* end() const {
+        return items + count;
+    }
+
+    bool operator==(const CheckpointList& other) const {
+        if(count != other.count) return false;
+        for(int i = 0; i < count; i++) {
+            if(!(items[i] == other.items[i])) return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const CheckpointList& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * The race layout and distances derived from it. It is one flat block, with no heap storage, and never changes
+ * during a game, so components keep a pointer to one shared Race rather than copies of it. Whoever creates the Race
+ * must keep it alive for as long as the Physics, Navigation, bots and GameStates built from it; they take it as a
+ * RaceRef, so that they can't be built from a temporary.
+ */
 class Race {
 public:
-    int laps;
-    vector<Vector> checkpoints;
-    vector<float> nextCPDistaces;
-    vector<float> previousCPDistances;
+    // Identifies the layout, so that snapshots can refer to the race without holding a pointer to it.
+    uint32_t id = 0;
+    int laps = 0;
+    CheckpointList checkpoints;
+    float nextCPDistaces[MAX_CHECKPOINTS];
+    float previousCPDistances[MAX_CHECKPOINTS];
     float maxCheckpointDist = 0;
 
     Race() {}
 
-    Race(int laps, vector<Vector> checkpoints) :
-            laps(laps), checkpoints(checkpoints) {
-        previousCPDistances.push_back(0);
-        for(int i = 0; i < checkpoints.size()-1; i++) {
-            nextCPDistaces.push_back((checkpoints[i] - checkpoints[i+1]).getLength());
-            previousCPDistances.push_back(nextCPDistaces[i]);
+    Race(int laps, const vector<Vector>& cps) : laps(laps) {
+        // The game never has more than MAX_CHECKPOINTS.
+        assert(cps.size() <= MAX_CHECKPOINTS);
+        checkpoints.count = min((int) cps.size(), MAX_CHECKPOINTS);
+        int n = checkpoints.count;
+        for(int i = 0; i < n; i++) {
+            checkpoints[i] = cps[i];
+        }
+        for(int i = 0; i < n; i++) {
+            nextCPDistaces[i] = (checkpoints[i] - checkpoints[(i + 1) % n]).getLength();
+            previousCPDistances[(i + 1) % n] = nextCPDistaces[i];
             maxCheckpointDist = max(maxCheckpointDist, nextCPDistaces[i]);
         }
-        nextCPDistaces.push_back((checkpoints[checkpoints.size()-1] - checkpoints[0]).getLength());
-        previousCPDistances[0] = nextCPDistaces[checkpoints.size()-1];
-        maxCheckpointDist = max(maxCheckpointDist, nextCPDistaces[checkpoints.size()-1]);
+        id = layoutId(laps, checkpoints);
+    }
+
+    /**
+     * FNV-1a hash of the lap count and the (integer) checkpoint positions.
+     */
+    static uint32_t layoutId(int laps, const CheckpointList& checkpoints) {
+        uint32_t h = 2166136261u;
+        auto mix = [&h](int32_t v) {
+            for(int b = 0; b < 4; b++) {
+                h ^= (v >> (8 * b)) & 0xff;
+                h *= 16777619u;
+            }
+        };
+        mix(laps);
+        for(int i = 0; i < checkpoints.size(); i++) {
+            mix((int32_t) checkpoints[i].x);
+            mix((int32_t) checkpoints[i].y);
+        }
+        return h;
     }
 
-    float distToNextCP(int fromCP) {
+    float distToNextCP(int fromCP) const {
         return nextCPDistaces[fromCP];
     }
 
-    float distFromPrevCP(int toCP) {
+    float distFromPrevCP(int toCP) const {
         return previousCPDistances[toCP];
     }
 
-    int totalCPCount() {
+    int totalCPCount() const {
         return laps * checkpoints.size();
     }
 
-    int followingCheckpoint(int cp) {
+    int followingCheckpoint(int cp) const {
         return (cp + 1) % checkpoints.size();
     }
 };
 
+/**
+ * A race for a component to keep a pointer to: it binds to a named Race, but not to a temporary one.
+ */
+class RaceRef {
+    const Race* race;
+public:
+    RaceRef(const Race& race) : race(&race) {}
+
+    RaceRef(const Race&& race) = delete;
+
+    const Race* get() const {
+        return race;
+    }
+
+    const Race* operator->() const {
+        return race;
+    }
+
+    operator const Race&() const {
+        return *race;
+    }
+};
+
 struct PodState {
     Vector pos;
     Vector vel;
@@ -132,18 +231,60 @@ struct PlayerState {
     }
 };
 
+/**
+ * Everything about a game that changes from turn to turn: the pods (with their shield and boost cooldowns and
+ * checkpoint progress), each player's lead pod and the turn. The race is referred to by its id, so a snapshot is a
+ * fixed-size block that can be copied with a single memcpy, kept in arrays, or written to disk.
+ */
+struct GameSnapshot {
+    uint32_t raceId = 0;
+    int32_t turn = 0;
+    PlayerState playerStates[PLAYER_COUNT];
+};
+
+static_assert(is_trivially_copyable<GameSnapshot>::value, "GameSnapshot must be copyable with memcpy");
+static_assert(sizeof(GameSnapshot) == 2 * sizeof(int32_t) + PLAYER_COUNT * sizeof(PlayerState),
+              "GameSnapshot must not hold anything besides the game's changing state");
+static_assert(sizeof(GameSnapshot) <= 512, "GameSnapshot should stay within eight cache lines");
+
 struct GameState {
-    Race race;
+    const Race* race = nullptr;
     PlayerState playerStates[PLAYER_COUNT];
     int turn = 0;
 
     GameState() {};
 
-    GameState(Race& race, PlayerState inPlayerStates[], int turn) :
-            race(race), turn(turn) {
+    GameState(RaceRef race, PlayerState inPlayerStates[], int turn) :
+            race(race.get()), turn(turn) {
         memcpy(playerStates, inPlayerStates, PLAYER_COUNT*sizeof(PlayerState));
     }
 
+    GameState(RaceRef race, const GameSnapshot& snapshot) {
+        restore(race, snapshot);
+    }
+
+    void save(GameSnapshot& snapshot) const {
+        snapshot.raceId = race ? race->id : 0;
+        snapshot.turn = turn;
+        memcpy(snapshot.playerStates, playerStates, sizeof(playerStates));
+    }
+
+    GameSnapshot save() const {
+        GameSnapshot snapshot;
+        save(snapshot);
+        return snapshot;
+    }
+
+    /**
+     * Return to a saved game. The race must be the one the snapshot was saved from.
+     */
+    void restore(RaceRef race, const GameSnapshot& snapshot) {
+        assert(snapshot.raceId == race->id);
+        this->race = race.get();
+        turn = snapshot.turn;
+        memcpy(playerStates, snapshot.playerStates, sizeof(playerStates));
+    }
+
     PlayerState& ourState() {
         return playerStates[OUR_PLAYER_ID];
     }
@@ -219,14 +360,23 @@ class State {
     GameState previous;
     GameState current;
 public:
-    Race race;
+    const Race* race = nullptr;
     int turn = 0;
 
     State() {}
-    State(Race race) : race(race) {}
+    State(RaceRef race) : race(race.get()) {}
     void preTurnUpdate(PlayerState input[]);
     void postTurnUpdate(PodOutputAbs pod1, PodOutputAbs pod2);
     GameState& game() {return current;}
+
+    /**
+     * Save the game as of the last postTurnUpdate(), so at least one turn must have been played. Restoring it
+     * continues from the following turn, so search and pondering can branch from the same point as often as they
+     * like.
+     */
+    GameSnapshot save() const;
+
+    void restore(const GameSnapshot& snapshot);
 };
 
 #endif //CODERSSTRIKEBACK_GAMESTATE_H
@@ -38,10 +38,8 @@ public:
 
     Vector(float x, float y, float length, float lengthSq) : x(x), y(y), length(length), lengthSq(lengthSq) {}
 
-    // Use default.
-    //Vector(const Vector& vector);
-
-    ~Vector() {};
+    // Use the implicit copy and destructor, so that Vector, and the game states built from it, stay trivially
+    // copyable.
 
     static Vector fromMagAngle(const float magnitude, const float angle) {
         return Vector(magnitude * std::cos(angle), magnitude * std::sin(angle));
@@ -3,32 +3,80 @@
 #include <stdlib.h>
 #include "State.h"
 #include "InputParser.h"
-#include "PodracerBot.h"
+#include "FastIO.h"
 #include "Physics.h"
 #include "AnnealingBot.h"
+#include "OpeningBook.h"
+#include "OpeningBookData.h"
+#include "RacingLines.h"
+#include "ProfileScope.h"
 #include <chrono>
 
 int main() {
-    InputParser inputParser(cin);
+    FastInput input(0);
+    FastOutput output(1);
+    InputParser inputParser(input);
     Race race = inputParser.init();
     State state(race);
     State enemyState(race);
     Physics physics(race);
     std::srand(std::time(0));
 
-    AnnealingBot<5> bot(race, 109);
+    static const int botTimeMilli = 109;
+    static const int enemyBotTimeMilli = 39;
+    // The first turn may take up to a second.
+    static const int firstTurnMilli = 900;
+    AnnealingBot<5> bot(race, botTimeMilli);
 //    AnnealingBot<4> botFake(race, 30);
-    AnnealingBot<4> enemyBot(race, 39);
+    AnnealingBot<4> enemyBot(race, enemyBotTimeMilli);
+    OpeningBook book(OPENING_BOOK, OPENING_BOOK_SIZE);
+    PairOutput opening[OpeningBook::PLAN_TURNS];
+    PairOutput enemyOpening[OpeningBook::PLAN_TURNS];
+    RacingLines lines;
     // Game loop.
     while (1) {
-        long long startTime = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+        // The turn's clock starts when its input arrives, not when we get to read it.
+        input.beginTurn();
+        if(input.eof()) break;
+        long long startTime = input.turnArrival();
         PlayerState players[PLAYER_COUNT];
         inputParser.parseTurn(players);
         state.preTurnUpdate(players);
+        // Both searches start from the book's plans through the opening, the opponent's too.
+        int turn = state.game().turn;
+        if(turn == 0) {
+            bool inBook = book.lookup(race, state.game().ourState().pods, opening);
+            book.lookup(race, state.game().enemyState().pods, enemyOpening);
+            cerr << (inBook ? "Opening from the book" : "Opening not in the book") << endl;
+        }
+        if(turn < OpeningBook::PLAN_TURNS) {
+            enemyBot.addSeed(enemyOpening + turn, OpeningBook::PLAN_TURNS - turn);
+            bot.addSeed(opening + turn, OpeningBook::PLAN_TURNS - turn);
+        }
+        // The long first turn goes on what the rest of the game reuses: the racing lines, and searches far deeper
+        // than usual, which the next turns' searches start from.
+        long enemyTimeMilli = enemyBotTimeMilli;
+        long ourTimeMilli = botTimeMilli;
+        if(turn == 0) {
+            lines = RacingLines(race);
+            enemyBot.setRacingLines(&lines);
+            bot.setRacingLines(&lines);
+            PairOutput lineSeed[OpeningBook::PLAN_TURNS];
+            lines.startSeed(lineSeed, OpeningBook::PLAN_TURNS);
+            enemyBot.addSeed(lineSeed, OpeningBook::PLAN_TURNS);
+            bot.addSeed(lineSeed, OpeningBook::PLAN_TURNS);
+            // What's left is split between the searches as on the other turns.
+            long long spent = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count() - startTime;
+            enemyTimeMilli = spent + (firstTurnMilli - spent) * enemyBotTimeMilli / (botTimeMilli + enemyBotTimeMilli);
+            ourTimeMilli = firstTurnMilli - enemyTimeMilli;
+        }
+        enemyBot.setBudget(SearchBudget::time(enemyTimeMilli));
+        bot.setBudget(SearchBudget::time(ourTimeMilli));
         // Train opponent.
         PairOutput enemySolution[4];
         PodState ourStateExpectedByEnemy[4][2];
 //        enemyBot.sFactors.skirtBonus = 0;
+        enemyBot.startClockAt(startTime);
         enemyBot.train(state.game().enemyState().pods, state.game().ourState().pods, enemySolution, ourStateExpectedByEnemy[0]);
         static int startFromTurn = 0;
         CustomAIWithBackup<4> enemyAI(race, enemySolution, ourStateExpectedByEnemy, startFromTurn);
@@ -49,13 +97,16 @@ int main() {
 
         // Train our bot.
         bot.setEnemyAI(&enemyAI);
+        bot.startClockAt(startTime + enemyTimeMilli);
         PairOutput control = bot.move(state.game());
         PodOutputAbs po1 = control.o1.absolute(state.game().ourState().pods[0]);
         PodOutputAbs po2 = control.o2.absolute(state.game().ourState().pods[1]);
-        cout << po1.toString() << endl
-             << po2.toString() << endl;
+        output.write(po1);
+        output.write(po2);
+        output.flush();
         state.postTurnUpdate(po1, po2);
         long long endTime = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
         cerr << "Runtime: " << endTime-startTime << endl;
+        PROFILE_DUMP("turn");
     }
 }
\ No newline at end of file
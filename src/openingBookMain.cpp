@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "AnnealingBot.h"
+#include "OpeningBook.h"
+#include "RaceGenerator.h"
+#include "Simulation.h"
+
+// Size of a file, or -1 if it can't be read.
+static long fileBytes(const string& path) {
+    ifstream f(path, ios::binary | ios::ate);
+    return f ? (long) f.tellg() : -1;
+}
+
+// Builds an opening book: a deep search of the first turns from both sides of the start grid of each race in a corpus.
+// Usage: openingBook --corpus <races> --out <book> [--races N] [--rollouts N]
+//                    [--header <file> --merged <merged.cpp> [--max-source-bytes N]]
+// The header is only written if the merged bot stays within the game's source size limit. --merged is the bot as
+// merge.py last built it, with the current header; the new header may take what the rest of it leaves.
+int main(int argc, char* argv[]) {
+    RaceCorpus corpus;
+    string out;
+    string header;
+    int races = 100;
+    long rollouts = 400000;
+    string merged;
+    // The game's source size limit.
+    long maxSourceBytes = 100000;
+    for(int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if(arg == "--corpus" && i + 1 < argc) {
+            if(!corpus.load(argv[++i])) {
+                cerr << "Could not load race corpus: " << argv[i] << endl;
+                return 1;
+            }
+        } else if(arg == "--out" && i + 1 < argc) {
+            out = argv[++i];
+        } else if(arg == "--races" && i + 1 < argc) {
+            races = atoi(argv[++i]);
+        } else if(arg == "--rollouts" && i + 1 < argc) {
+            rollouts = atol(argv[++i]);
+        } else if(arg == "--header" && i + 1 < argc) {
+            header = argv[++i];
+        } else if(arg == "--merged" && i + 1 < argc) {
+            merged = argv[++i];
+        } else if(arg == "--max-source-bytes" && i + 1 < argc) {
+            maxSourceBytes = atol(argv[++i]);
+        } else {
+            cerr << "Unknown argument: " << arg << endl;
+            return 1;
+        }
+    }
+    if(corpus.empty() || out.empty() || header.empty() != merged.empty()) {
+        cerr << "Usage: " << argv[0] << " --corpus <races> --out <book> [--races N] [--rollouts N]"
+             << " [--header <file> --merged <merged.cpp> [--max-source-bytes N]]" << endl;
+        return 1;
+    }
+    long otherBytes = 0;
+    if(!header.empty()) {
+        long mergedBytes = fileBytes(merged);
+        if(mergedBytes < 0) {
+            cerr << "Could not read " << merged << endl;
+            return 1;
+        }
+        // The current header is replaced, so only the rest of the merged bot counts against the limit.
+        otherBytes = mergedBytes - max(0L, fileBytes(header));
+        if(otherBytes >= maxSourceBytes) {
+            cerr << "Not embedding: without the book the merged bot is already " << otherBytes << " bytes, over the "
+                 << maxSourceBytes << " byte limit" << endl;
+            return 1;
+        }
+    }
+    races = min(races, corpus.size());
+    OpeningBook book;
+    for(int i = 0; i < races; i++) {
+        Race race = corpus.race(i);
+        Simulation sim(race);
+        PodState aPods[POD_COUNT];
+        PodState bPods[POD_COUNT];
+        sim.initializePods(aPods, bPods);
+        const PodState* sides[][2] = {{aPods, bPods}, {bPods, aPods}};
+        for(int s = 0; s < 2; s++) {
+            AnnealingBot<OpeningBook::PLAN_TURNS> bot(race, SearchBudget::rollouts(rollouts));
+            bot.seed(Random::mix(corpus.generatorSeed(), 2 * i + s));
+            PairOutput plan[OpeningBook::PLAN_TURNS];
+            PodState expected[OpeningBook::PLAN_TURNS][POD_COUNT];
+            if(bot.train(sides[s][0], sides[s][1], plan, expected[0])) {
+                // Back to input order.
+                for(int t = 0; t < OpeningBook::PLAN_TURNS; t++) {
+                    swap(plan[t].o1, plan[t].o2);
+                }
+            }
+            book.add(OpeningBook::layoutKey(race, sides[s][0]), plan);
+        }
+    }
+    if(!book.save(out)) {
+        cerr << "Failed to write " << out << endl;
+        return 1;
+    }
+    cerr << "Wrote " << book.size() << " plans to " << out << endl;
+    if(!header.empty()) {
+        size_t maxHeaderBytes = maxSourceBytes - otherBytes;
+        if(!book.saveHeader(header, maxHeaderBytes)) {
+            cerr << "Not embedded: the book doesn't fit in the " << maxHeaderBytes << " bytes the merged bot leaves"
+                 << endl;
+            return 1;
+        }
+        cerr << "Embedded in " << header << endl;
+    }
+    return 0;
+}
@@ -7,35 +7,105 @@
 #include <thread>
 #include <ctime>
 #include <math.h>
+#include <random>
+#include <atomic>
 
 #include "Simulation.h"
 #include "BlockingQueue.h"
+#include "CMAES.h"
+#include "RaceGenerator.h"
+#include "Profiler.h"
+#include "ProfileScope.h"
 
 
 Race race1(3, {Vector(6271,7739),Vector(14099,7732),Vector(13893,1242),Vector(10252,4891),Vector(6115,2174),Vector(3002,5192)}); // Large zigzag.
 Race race2(3, {Vector(9114,1850), Vector(4995,5264), Vector(11502,6107)}); // Medium-small circle
 Race race3(3, {Vector(12703,7107), Vector(4080,4634), Vector(13062,1891), Vector(6545,7845), Vector(7473,1372)}); // Large crossed circle
 
+// Generated maps (see raceGen). When loaded, evaluations sample from it instead of using race1-race3.
+RaceCorpus corpus;
 
-void gameRunner(Simulation sim, ScoreFactors sf, double* ans) {
+
+// When set (--record), every evaluation game is written to a binary replay in this directory.
+string recordDir;
+atomic<int> recordedGames(0);
+
+void gameRunner(Simulation sim, ScoreFactors sf, double* ans, Profiler::Stats* profile) {
+    ReplayWriter replayWriter;
+    if(!recordDir.empty()) {
+        replayWriter.open(recordDir + "/game_" + to_string(recordedGames++) + ".csbr", sim.getRace());
+        sim.recordTo(&replayWriter);
+    }
     *ans = sim.fullGameParamSim(sf, false);
+    *profile = Profiler::take();
 }
 
-float runMultiGame(ScoreFactors sf) {
-    Simulation sims[3] = {Simulation(race1), Simulation(race2), Simulation(race3)};
-    thread workers[3];
-    double scores[3] = {0};
-    for(int i = 0; i < 3; i++) {
-        workers[i] = thread(gameRunner, sims[i], sf, &scores[i]);
+// The maps and bot seeds of one evaluation all derive from `seed`: evaluations sharing a seed play the same maps with
+// the same random streams in every bot.
+vector<Simulation> evaluationGames(uint64_t seed) {
+    if(corpus.empty()) {
+        return {Simulation(race1, Random::mix(seed, 0)), Simulation(race2, Random::mix(seed, 1)),
+                Simulation(race3, Random::mix(seed, 2))};
     }
-    for(int i = 0; i < 3; i++) {
-        workers[i].join();
+    mt19937_64 rng(seed);
+    return {Simulation(corpus.sample(rng), Random::mix(seed, 0)), Simulation(corpus.sample(rng), Random::mix(seed, 1)),
+            Simulation(corpus.sample(rng), Random::mix(seed, 2))};
+}
+
+// Plays the evaluation games for every set of factors at once, one thread per game, and returns their mean scores.
+// The games' profiling counters are added to profile, if given.
+vector<double> runMultiGames(const vector<ScoreFactors>& factors, uint64_t seed, Profiler::Stats* profile = nullptr) {
+    vector<Simulation> sims = evaluationGames(seed);
+    int games = sims.size();
+    vector<thread> workers;
+    vector<double> scores(factors.size() * games, 0);
+    vector<Profiler::Stats> profiles(factors.size() * games);
+    for(size_t f = 0; f < factors.size(); f++) {
+        for(int i = 0; i < games; i++) {
+            workers.push_back(thread(gameRunner, sims[i], factors[f], &scores[f * games + i], &profiles[f * games + i]));
+        }
+    }
+    for(auto& w : workers) {
+        w.join();
     }
-    double score = 0.0f;
-    for(int i = 0; i < 3; i++) {
-        score += scores[i];
+    if(profile) {
+        for(const Profiler::Stats& p : profiles) {
+            *profile += p;
+        }
     }
-    return score/3.0f;
+    vector<double> means(factors.size(), 0);
+    for(size_t f = 0; f < factors.size(); f++) {
+        for(int i = 0; i < games; i++) {
+            means[f] += scores[f * games + i] / games;
+        }
+    }
+    return means;
+}
+
+float runMultiGame(ScoreFactors sf, uint64_t seed, Profiler::Stats* profile = nullptr) {
+    return runMultiGames({sf}, seed, profile)[0];
+}
+
+/**
+ * Common random numbers: the candidate and the incumbent play the same maps with identical bot seeds, so most of the
+ * game-to-game noise cancels in their difference.
+ *
+ * @return candidate score - incumbent score.
+ */
+double runPairedMultiGame(ScoreFactors candidate, ScoreFactors incumbent, uint64_t seed, double* candidateScore,
+                          Profiler::Stats* profile = nullptr) {
+    vector<double> scores = runMultiGames({candidate, incumbent}, seed, profile);
+    *candidateScore = scores[0];
+    return scores[0] - scores[1];
+}
+
+// Only called from the master thread.
+uint64_t nextSeed() {
+    return ((uint64_t) lrand48() << 31) ^ (uint64_t) lrand48();
+}
+
+float runMultiGame(ScoreFactors sf) {
+    return runMultiGame(sf, nextSeed());
 }
 
 GameHistory runFullGameTest(ScoreFactors sf) {
@@ -154,6 +224,46 @@ ScoreFactors generateScoreFactor() {
     return sf;
 }
 
+// The range each tunable field is drawn from in generateScoreFactor. overallRacer and overallBouncer stay fixed at 1.
+struct FactorBound {
+    float ScoreFactors::* field;
+    float low;
+    float high;
+};
+
+static const FactorBound factorBounds[] = {
+        {&ScoreFactors::passCPBonus,          0, 6000},
+        {&ScoreFactors::progressToCP,         0,    2},
+        {&ScoreFactors::enemyProgress,       -1,    0},
+        {&ScoreFactors::earlyPassBonus,       0, 6000},
+        {&ScoreFactors::enemyDist,           -2,    0},
+        {&ScoreFactors::enemyDistToCP,        0,    2},
+        {&ScoreFactors::bouncerDistToCP,     -2,    0},
+        {&ScoreFactors::angleSeenByEnemy,    -2,    0},
+        {&ScoreFactors::angleSeenByCP,       -2,    0},
+        {&ScoreFactors::bouncerTurnAngle,    -2,    0},
+        {&ScoreFactors::enemyTurnAngle,      -2,    0},
+        {&ScoreFactors::checkpointPenalty, -6000,   0},
+        {&ScoreFactors::skirtBonus,           0, 6000},
+        {&ScoreFactors::shieldPenalty,    -1000,    0}
+};
+static const int FACTOR_COUNT = sizeof(factorBounds) / sizeof(FactorBound);
+
+vector<double> toVector(const ScoreFactors& sf) {
+    vector<double> v;
+    for(int i = 0; i < FACTOR_COUNT; i++) {
+        v.push_back(sf.*factorBounds[i].field);
+    }
+    return v;
+}
+
+ScoreFactors fromVector(const vector<double>& v, ScoreFactors base) {
+    for(int i = 0; i < FACTOR_COUNT; i++) {
+        base.*factorBounds[i].field = v[i];
+    }
+    return base;
+}
+
 ScoreFactors testScoreFactors() {
     ScoreFactors sf = {};
     sf.overallRacer = 1;
@@ -180,7 +290,6 @@ ScoreFactors startingSFs() {
     sf.passCPBonus = 4276;
     sf.progressToCP = 1.91;
     sf.enemyProgress = -0.932;
-    sf.tangentVelBonus = 40;
     sf.overallBouncer = 1;
     sf.enemyDist = -0.079;
     sf.enemyDistToCP = 1.41;
@@ -259,12 +368,20 @@ struct Job {
     ScoreFactors config;
     double temp;
     double currentScore;
+    // Lets the master match results to jobs when they come back out of order.
+    int id;
+    // With paired set, config is judged on its paired difference against incumbent, both playing the games of seed.
+    ScoreFactors incumbent;
+    uint64_t seed;
+    bool paired;
 };
 
 struct Result {
     ScoreFactors config;
     double score;
     bool accepted;
+    int id;
+    double pairedDiff;
 };
 
 
@@ -283,14 +400,17 @@ void worker() {
         }
         cerr << "Thread #" << this_thread::get_id() << " starting job." << endl;
         double score = runGame(j.config);
+        PROFILE_DUMP("job " + to_string(j.id));
         double scoreDiff = -(score - j.currentScore);
-        double flip = (float) drand48() / RAND_MAX;
+        double flip = drand48();
         double acc = exp(-scoreDiff / j.temp);
         bool accepted = scoreDiff < 0 || acc > flip;
         Result res = {
                 j.config,
                 score,
-                accepted};
+                accepted,
+                j.id,
+                0};
         resultQueue.push(res);
         cerr << "Thread #" << this_thread::get_id() << " finished job." << endl;
     }
@@ -306,16 +426,28 @@ void multiGameWorker() {
             return;
         }
         cerr << "Thread #" << this_thread::get_id() << " starting job." << endl;
-        double score = runMultiGame(j.config);
-        double scoreDiff = -(score - j.currentScore);
-        double flip = (float) drand48() / RAND_MAX;
-        double acc = exp(-scoreDiff / j.temp);
-        bool accepted = scoreDiff < 0 || acc > flip;
+        double score;
+        double pairedDiff = 0;
+        bool accepted;
+        Profiler::Stats profile;
+        if(j.paired) {
+            pairedDiff = runPairedMultiGame(j.config, j.incumbent, j.seed, &score, &profile);
+            accepted = pairedDiff > 0 || exp(pairedDiff / j.temp) > drand48();
+        } else {
+            score = runMultiGame(j.config, j.seed, &profile);
+            double scoreDiff = -(score - j.currentScore);
+            double flip = drand48();
+            double acc = exp(-scoreDiff / j.temp);
+            accepted = scoreDiff < 0 || acc > flip;
+        }
         Result res = {
                 j.config,
                 score,
-                accepted};
+                accepted,
+                j.id,
+                pairedDiff};
         resultQueue.push(res);
+        Profiler::dump(cerr, "job " + to_string(j.id), profile);
         cerr << "Thread #" << this_thread::get_id() << " finished job. Score: " << score << endl;
     }
 }
@@ -339,26 +471,27 @@ ScoreFactors optimize() {
     for(int i = 0; i < WORKER_COUNT; i++) {
         workers.push_back(thread(multiGameWorker));
     }
-    ScoreFactors current = AnnealingBot().sFactors;//startingSFs();
+    ScoreFactors current = defaultFactors;//startingSFs();
     double currentScore = runMultiGame(current);
-    double bestScore = currentScore;
     ScoreFactors bestFactors = current;
     double prevTemp = initialTemp;
     double temp = initialTemp;
     double sdPrev = initialSD;
     for(int i = 0; i < tempReductions; i++) {
         int acceptCount = 0;
+        // Statistics are over the paired differences, as that is what the temperature is compared against. The
+        // first sample is the incumbent against itself.
         int count = 1;
-        double mean = currentScore;
-        double delta = currentScore - 0.0;
-        double M2 = 0.0 + delta*(currentScore-mean);
+        double mean = 0.0;
+        double delta = 0.0;
+        double M2 = 0.0;
         vector<Result> accepted;
         for(int j = 0; j < neighorhoodSize;) {
             // Feed the workers.
             for(int y = 0; y < WORKER_COUNT; y++) {
 //                ScoreFactors altered = randomAlter(current);
                 ScoreFactors altered = randomAlter2(current);
-                Job job = {false, altered, temp, currentScore};
+                Job job = {false, altered, temp, currentScore, j, current, nextSeed(), true};
                 jobQueue.push(job);
             }
             for(int z = 0; z < WORKER_COUNT && j < neighorhoodSize; z++) {
@@ -372,14 +505,14 @@ ScoreFactors optimize() {
                 if(accepted.empty()) {
 //                    ScoreFactors altered = randomAlter(current);
                     ScoreFactors altered = randomAlter2(current);
-                    Job job = {false, altered, temp, currentScore};
+                    Job job = {false, altered, temp, currentScore, j, current, nextSeed(), true};
                     jobQueue.push(job);
                 }
                 // Online mean & variance.
                 count++;
-                delta = res.score - mean;
+                delta = res.pairedDiff - mean;
                 mean += delta/count;
-                M2 += delta*(res.score - mean);
+                M2 += delta*(res.pairedDiff - mean);
                 // Increment trial counter.
                 j++;
             }
@@ -388,9 +521,13 @@ ScoreFactors optimize() {
                 int randomIdx = (int) (drand48() * accepted.size());
                 current = accepted[randomIdx].config;
                 currentScore = accepted[randomIdx].score;
-                if(currentScore > bestScore) {
-                    bestScore = currentScore;
+                // Scores from different seeds can't be compared, so the new incumbent only becomes the best if it
+                // beats the best on the same games.
+                double score;
+                double margin = runPairedMultiGame(current, bestFactors, nextSeed(), &score);
+                if(margin > 0) {
                     bestFactors = current;
+                    cerr << "New best, by " << margin << endl;
                 }
                 accepted.clear();
             }
@@ -406,11 +543,10 @@ ScoreFactors optimize() {
         temp = nextTemperature(temp, sd, lambda);
         cerr << "Current score: " << currentScore << endl;
         cerr << "Current score factors: " << endl << printScoreFactors(current) << endl;
-        cerr << "Best score: " << bestScore << endl;
         cerr << "Best factors: " << endl << printScoreFactors(bestFactors) << endl;
     }
     for(int i = 0; i < WORKER_COUNT; i++) {
-        jobQueue.push({true, 0, 0, 0});
+        jobQueue.push({true, {}, 0, 0, 0, {}, 0, false});
     }
     for(int i = 0; i < WORKER_COUNT; i++) {
         workers[i].join();
@@ -419,28 +555,97 @@ ScoreFactors optimize() {
     return current;
 }
 
+// Alternative to optimize(): separable CMA-ES over the factors in factorBounds. Each generation is one batch of jobs,
+// so the population size is matched to the worker count.
+const int cmaGenerations = 120;
+constexpr double cmaInitialSigma = 0.3;
 
+ScoreFactors optimizeCMAES() {
+    vector<thread> workers;
+    for(int i = 0; i < WORKER_COUNT; i++) {
+        workers.push_back(thread(multiGameWorker));
+    }
+    ScoreFactors start = defaultFactors;
+    vector<double> lower;
+    vector<double> upper;
+    for(int i = 0; i < FACTOR_COUNT; i++) {
+        lower.push_back(factorBounds[i].low);
+        upper.push_back(factorBounds[i].high);
+    }
+    SepCMAES cma(toVector(start), lower, upper, cmaInitialSigma, (unsigned) time(0), WORKER_COUNT);
+    ScoreFactors bestFactors = start;
+    for(int i = 0; i < cmaGenerations; i++) {
+        vector<vector<double>> population = cma.ask();
+        // The whole generation plays the same games, so ranking is not swamped by map and seed noise.
+        uint64_t generationSeed = nextSeed();
+        for(int k = 0; k < (int) population.size(); k++) {
+            Job job = {false, fromVector(population[k], start), 1, 0, k, start, generationSeed, false};
+            jobQueue.push(job);
+        }
+        vector<double> costs(population.size());
+        double generationMean = 0;
+        Result generationBest;
+        for(int k = 0; k < (int) population.size(); k++) {
+            Result res = resultQueue.pop();
+            // CMA-ES minimizes; the simulation score is higher for better factors.
+            costs[res.id] = -res.score;
+            generationMean += res.score / population.size();
+            if(k == 0 || res.score > generationBest.score) {
+                generationBest = res;
+            }
+        }
+        cma.tell(population, costs);
+        cerr << "Generation " << i << " of " << cmaGenerations << "  mean score: " << generationMean
+             << "  sigma: " << cma.sigma() << endl;
+        // Generations play different games, so the generation's best only becomes the best if it beats the best on
+        // the same games.
+        if(i == 0) {
+            bestFactors = generationBest.config;
+        } else {
+            jobQueue.push({false, generationBest.config, 1, 0, 0, bestFactors, nextSeed(), true});
+            Result res = resultQueue.pop();
+            if(res.pairedDiff > 0) {
+                bestFactors = res.config;
+                cerr << "New best, by " << res.pairedDiff << endl;
+            }
+        }
+        cerr << "Mean factors: " << endl << printScoreFactors(fromVector(cma.mean(), start)) << endl;
+    }
+    for(int i = 0; i < WORKER_COUNT; i++) {
+        jobQueue.push({true, {}, 0, 0, 0, {}, 0, false});
+    }
+    for(int i = 0; i < WORKER_COUNT; i++) {
+        workers[i].join();
+    }
+    // The distribution mean averages out the evaluation noise that a single lucky best sample carries.
+    ScoreFactors meanFactors = fromVector(cma.mean(), start);
+    finalScore = runMultiGame(meanFactors);
+    cerr << "Best sampled factors: " << endl << printScoreFactors(bestFactors) << endl;
+    return meanFactors;
+}
 
 
 int main(int argc, char* argv[]) {
-    // Setup io
-    ostream *out;
-    ofstream fout;
-    if (argc > 1) {
-        fout.open(argv[1]);
-        out = &fout;
-    } else {
-        out = &cout;
+    bool useCMAES = false;
+    for(int i = 1; i < argc; i++) {
+        if(string(argv[i]) == "--cmaes") {
+            useCMAES = true;
+        } else if(string(argv[i]) == "--record" && i + 1 < argc) {
+            recordDir = argv[++i];
+        } else if(string(argv[i]) == "--corpus" && i + 1 < argc) {
+            if(!corpus.load(argv[++i])) {
+                cerr << "Could not load race corpus: " << argv[i] << endl;
+                return 1;
+            }
+            cerr << "Loaded " << corpus.size() << " races." << endl;
+        } else {
+            cerr << "Unknown argument: " << argv[i] << endl;
+            return 1;
+        }
     }
     // Optimizing
     srand48(time(0));
-    ScoreFactors finalSF = optimize();
+    ScoreFactors finalSF = useCMAES ? optimizeCMAES() : optimize();
     cout << "Final score: " << endl << finalScore << endl;
     cout << "Final score factors: " << endl << printScoreFactors(finalSF) << endl;
-
-    // Testing
-//    GameHistory gh = runFullGameTest(testScoreFactors());
-//    *out << "gameData = ";
-//    gh.writeToStream(*out);
-//    *out << ";";
 }
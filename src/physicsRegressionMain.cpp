@@ -0,0 +1,55 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+#include "PhysicsRegression.h"
+
+// Re-simulates recorded games and fails if Physics no longer reproduces them.
+// Usage: physicsRegression <replay file or directory>... [--max-pos-error E] [--max-vel-error E]
+//        [--max-mismatches N] [--seconds S]
+int main(int argc, char* argv[]) {
+    // The recordings are produced by our own simulator, not the referee, so by default nothing may change.
+    float maxPosError = 0;
+    float maxVelError = 0;
+    long maxMismatches = 0;
+    double seconds = 2;
+    PhysicsRegression regression;
+    int files = 0;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--max-pos-error") == 0 && i + 1 < argc) {
+            maxPosError = atof(argv[++i]);
+        } else if(strcmp(argv[i], "--max-vel-error") == 0 && i + 1 < argc) {
+            maxVelError = atof(argv[++i]);
+        } else if(strcmp(argv[i], "--max-mismatches") == 0 && i + 1 < argc) {
+            maxMismatches = atol(argv[++i]);
+        } else if(strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else {
+            int read = regression.addPath(argv[i]);
+            if(read < 0) {
+                cerr << "Could not read replays from " << argv[i] << endl;
+                return 2;
+            }
+            files += read;
+        }
+    }
+    if(regression.caseCount() == 0) {
+        cerr << "Usage: " << argv[0] << " <replay file or directory>... [--max-pos-error E] [--max-vel-error E] "
+             << "[--max-mismatches N] [--seconds S]" << endl;
+        return 2;
+    }
+    cout << "Loaded " << regression.caseCount() << " turns from " << files << " replays." << endl;
+    RegressionReport report = regression.check();
+    regression.measureThroughput(report, seconds);
+    report.print(cout);
+
+    bool pass = report.posError.max <= maxPosError && report.velError.max <= maxVelError &&
+                report.checkpointMismatches <= maxMismatches;
+    if(!pass) {
+        cout << "FAIL: max position error " << report.posError.max << ", max velocity error " << report.velError.max
+             << ", " << report.checkpointMismatches << " checkpoint mismatches." << endl;
+    } else {
+        cout << "PASS" << endl;
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "RaceGenerator.h"
+
+// Writes a race corpus for paramSim and simulation to stream through.
+// Usage: raceGen <output file> [count] [seed]
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        cerr << "Usage: " << argv[0] << " <output file> [count] [seed]" << endl;
+        return 1;
+    }
+    int count = argc > 2 ? atoi(argv[2]) : 10000;
+    uint64_t seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1;
+    RaceCorpus corpus = RaceCorpus::generate(seed, count);
+    if(!corpus.save(argv[1])) {
+        cerr << "Failed to write " << argv[1] << endl;
+        return 1;
+    }
+    cerr << "Wrote " << corpus.size() << " races (seed " << seed << ", version " << RaceCorpus::VERSION << ") to "
+         << argv[1] << endl;
+    return 0;
+}
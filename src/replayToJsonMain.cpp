@@ -0,0 +1,32 @@
+#include <iostream>
+#include <fstream>
+
+#include "Simulation.h"
+#include "Replay.h"
+
+// Converts a binary replay to the JSON the visualizer reads.
+// Usage: replayToJson <replay file> [output file]
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        cerr << "Usage: " << argv[0] << " <replay file> [output file]" << endl;
+        return 1;
+    }
+    ReplayReader reader;
+    if(!reader.open(argv[1])) {
+        cerr << "Not a readable replay (version " << replay::VERSION << "): " << argv[1] << endl;
+        return 1;
+    }
+    ostream* out;
+    ofstream fout;
+    if(argc > 2) {
+        fout.open(argv[2]);
+        out = &fout;
+    } else {
+        out = &cout;
+    }
+    GameHistory gh = GameHistory::fromReplay(reader);
+    *out << "gameData = ";
+    gh.writeToStream(*out);
+    *out << ";";
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include "Simulation.h"
+#include "RaceGenerator.h"
+
+// Measures end-to-end self-play throughput: the same fixed-seed, fixed-budget games are played with each thread
+// count, and the results are printed as a single JSON object so that runs can be diffed across commits and machines.
+//
+// Usage: selfplay_bench [--games N] [--threads 1,2,4] [--seed S] [--corpus path]
+//                       [--model-rollouts N] [--bot-rollouts N] [--tail-turns N] [--edit-screen]
+//                       [--no-score-cache] [--endgame] [--verbose]
+
+struct BenchRun {
+    int threads;
+    double seconds;
+    long turns;
+    long rollouts;
+    // Sum of the game scores. With deterministic budgets this must not change with the thread count.
+    double scoreSum;
+    EditScreen::Stats screen;
+    ScoreCache::Stats cache;
+};
+
+static vector<int> parseThreadCounts(const string& list) {
+    vector<int> counts;
+    stringstream ss(list);
+    string item;
+    while(getline(ss, item, ',')) {
+        int n = atoi(item.c_str());
+        if(n > 0) counts.push_back(n);
+    }
+    return counts;
+}
+
+static BenchRun run(const vector<Race>& races, uint64_t seed, SearchBudget modelBudget, SearchBudget botBudget,
+                    int tailTurns, bool useEditScreen, bool useScoreCache, bool useEndgameSolver, int threads) {
+    atomic<int> nextGame(0);
+    vector<double> scores(races.size());
+    vector<long> turns(races.size());
+    vector<long> rollouts(races.size());
+    vector<EditScreen::Stats> screens(races.size());
+    vector<ScoreCache::Stats> caches(races.size());
+    auto worker = [&]() {
+        for(int g = nextGame++; g < (int) races.size(); g = nextGame++) {
+            Simulation sim(races[g], Random::mix(seed, g));
+            sim.modelBudget = modelBudget;
+            sim.botBudget = botBudget;
+            sim.tailTurns = tailTurns;
+            sim.useEditScreen = useEditScreen;
+            sim.useScoreCache = useScoreCache;
+            sim.useEndgameSolver = useEndgameSolver;
+            scores[g] = sim.fullGameParamSim(defaultFactors, false);
+            turns[g] = sim.turnsPlayed;
+            rollouts[g] = sim.rollouts;
+            screens[g] = sim.screenStats;
+            caches[g] = sim.cacheStats;
+        }
+    };
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.push_back(thread(worker));
+    }
+    for(thread& t : workers) {
+        t.join();
+    }
+    BenchRun result;
+    result.threads = threads;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.turns = 0;
+    result.rollouts = 0;
+    result.scoreSum = 0;
+    for(int g = 0; g < (int) races.size(); g++) {
+        result.turns += turns[g];
+        result.rollouts += rollouts[g];
+        result.scoreSum += scores[g];
+        result.screen += screens[g];
+        result.cache += caches[g];
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int games = 16;
+    vector<int> threadCounts = {1, (int) max(1u, thread::hardware_concurrency())};
+    uint64_t seed = 1;
+    string corpusPath;
+    // Smaller than Simulation's defaults so that a benchmark finishes in minutes.
+    long modelRollouts = 2000;
+    long botRollouts = 6000;
+    int tailTurns = 0;
+    bool useEditScreen = false;
+    bool useScoreCache = true;
+    bool useEndgameSolver = false;
+    bool verbose = false;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCounts = parseThreadCounts(argv[++i]);
+        } else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpusPath = argv[++i];
+        } else if(strcmp(argv[i], "--model-rollouts") == 0 && i + 1 < argc) {
+            modelRollouts = atol(argv[++i]);
+        } else if(strcmp(argv[i], "--bot-rollouts") == 0 && i + 1 < argc) {
+            botRollouts = atol(argv[++i]);
+        } else if(strcmp(argv[i], "--tail-turns") == 0 && i + 1 < argc) {
+            tailTurns = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--edit-screen") == 0) {
+            useEditScreen = true;
+        } else if(strcmp(argv[i], "--no-score-cache") == 0) {
+            useScoreCache = false;
+        } else if(strcmp(argv[i], "--endgame") == 0) {
+            useEndgameSolver = true;
+        } else if(strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            cerr << "Unknown argument: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if(games <= 0 || threadCounts.empty()) {
+        cerr << "Need at least one game and one thread count." << endl;
+        return 1;
+    }
+
+    vector<Race> races;
+    if(!corpusPath.empty()) {
+        RaceCorpus corpus;
+        if(!corpus.load(corpusPath) || corpus.empty()) {
+            cerr << "Could not load race corpus: " << corpusPath << endl;
+            return 1;
+        }
+        for(int g = 0; g < games; g++) {
+            races.push_back(corpus.race(g % corpus.size()));
+        }
+    } else {
+        RaceGenerator generator(seed);
+        for(int g = 0; g < games; g++) {
+            races.push_back(generator.generate(g));
+        }
+    }
+
+    // The bots log every move; that isn't part of what's being measured.
+    streambuf* cerrBuf = cerr.rdbuf();
+    if(!verbose) cerr.rdbuf(nullptr);
+
+    SearchBudget modelBudget = SearchBudget::rollouts(modelRollouts);
+    SearchBudget botBudget = SearchBudget::rollouts(botRollouts);
+    vector<BenchRun> runs;
+    for(int threads : threadCounts) {
+        runs.push_back(run(races, seed, modelBudget, botBudget, tailTurns, useEditScreen, useScoreCache, useEndgameSolver, threads));
+    }
+    cerr.clear();
+    cerr.rdbuf(cerrBuf);
+
+    // Scaling efficiency is relative to the first thread count, which is normally 1.
+    const BenchRun& base = runs[0];
+    double baseRatePerThread = base.turns / base.seconds / base.threads;
+    json results;
+    for(const BenchRun& r : runs) {
+        json j;
+        j["threads"] = r.threads;
+        j["seconds"] = r.seconds;
+        j["gamesPerSecond"] = games / r.seconds;
+        j["turnsPerSecond"] = r.turns / r.seconds;
+        j["rolloutsPerSecond"] = r.rollouts / r.seconds;
+        j["scalingEfficiency"] = (r.turns / r.seconds / r.threads) / baseRatePerThread;
+        j["turns"] = r.turns;
+        j["rollouts"] = r.rollouts;
+        j["scoreSum"] = r.scoreSum;
+        if(useEditScreen) {
+            // Rollouts above count every edit looked at, the skipped ones too.
+            json screen;
+            screen["skipped"] = r.screen.skipped;
+            screen["skippedShare"] = (double) r.screen.skipped / max(1L, r.screen.proposals);
+            screen["precision"] = r.screen.precision();
+            screen["recall"] = r.screen.recall();
+            j["editScreen"] = screen;
+        }
+        if(useScoreCache) {
+            // Score cache hit rates by quarter of the annealing schedule.
+            json hitRates;
+            for(int phase = 0; phase < ScoreCache::PHASES; phase++) {
+                hitRates.push_back(r.cache.hitRate(phase));
+            }
+            j["cacheHitRates"] = hitRates;
+        }
+        results.push_back(j);
+    }
+    json out;
+    out["games"] = games;
+    out["seed"] = seed;
+    out["corpus"] = corpusPath;
+    out["modelRollouts"] = modelRollouts;
+    out["botRollouts"] = botRollouts;
+    out["tailTurns"] = tailTurns;
+    out["editScreen"] = useEditScreen;
+    out["scoreCache"] = useScoreCache;
+    out["endgame"] = useEndgameSolver;
+    out["hardwareThreads"] = thread::hardware_concurrency();
+    out["runs"] = results;
+    cout << out << endl;
+
+    for(const BenchRun& r : runs) {
+        if(r.scoreSum != base.scoreSum || r.turns != base.turns) {
+            cerr << "Warning: results differ between thread counts; games are not deterministic." << endl;
+            break;
+        }
+    }
+    return 0;
+}
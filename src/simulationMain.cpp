@@ -4,6 +4,7 @@
 #include "Simulation.h"
 #include "AnnealingBot.h"
 #include "PodracerBot.h"
+#include "RaceGenerator.h"
 
 Race r1(3, {Vector(1000, 340), Vector(11200, 2400), Vector(14200, 7700), Vector(5400, 8700)});
 Race r2(3, {Vector(12703,7107), Vector(4080,4634), Vector(13062,1891), Vector(6545,7845), Vector(7473,1372)}); // Large crossed circle
@@ -25,15 +26,45 @@ ScoreFactors sfs = {
         -4000
 };
 
+// Play one game on each of the first `games` maps of a corpus and report the scores.
+void runCorpus(const RaceCorpus& corpus, int games) {
+    double total = 0;
+    games = min(games, corpus.size());
+    for(int i = 0; i < games; i++) {
+        Simulation sim(corpus.race(i));
+        double score = sim.fullGameParamSim(sfs, false);
+        total += score;
+        cout << "Map " << i << ": " << score << endl;
+    }
+    cout << "Mean score over " << games << " maps: " << total / max(1, games) << endl;
+}
+
 int main(int argc, char* argv[]) {
     ostream* out;
     ofstream fout;
-    if(argc > 1) {
-        fout.open(argv[1]);
+    RaceCorpus corpus;
+    int games = 100;
+    for(int i = 1; i < argc; i++) {
+        if(string(argv[i]) == "--corpus" && i + 1 < argc) {
+            if(!corpus.load(argv[++i])) {
+                cerr << "Could not load race corpus: " << argv[i] << endl;
+                return 1;
+            }
+        } else if(string(argv[i]) == "--games" && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else {
+            fout.open(argv[i]);
+        }
+    }
+    if(fout.is_open()) {
         out = &fout;
     } else {
         out = &cout;
     }
+    if(!corpus.empty()) {
+        runCorpus(corpus, games);
+        return 0;
+    }
     DuelBot* b1 = new AnnealingBot<6>(r1, 120);
 //    DuelBot* b1 = new TraditionalBot();
     DuelBot* b2 = new TraditionalBot();
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "Simulation.h"
+#include "RaceGenerator.h"
+#include "MctsBot.h"
+#include "BeamBot.h"
+
+// Plays a challenger against the annealing self-player at equal rollout budgets. Each map is played twice with the
+// same seed, once from each side of the start grid, and the scores are from the challenger's side: positive means it
+// got further.
+//
+// Challengers: genetic (GeneticBot behind the same opponent model), mcts (MctsBot, one search for both players, given
+// the rollouts of both of the annealing player's searches), beam (BeamBot behind the same opponent model, searching
+// BEAM_TURNS turns ahead).
+//
+// Usage: tournament [--challenger genetic|mcts|beam] [--games N] [--threads T] [--seed S] [--corpus path]
+//                   [--model-rollouts N] [--bot-rollouts N] [--verbose]
+
+typedef SelfPlayer<6, AnnealingBot> AnnealingPlayer;
+typedef SelfPlayer<6, GeneticBot> GeneticPlayer;
+static const int BEAM_TURNS = 8;
+typedef SelfPlayer<BEAM_TURNS, BeamBot> BeamPlayer;
+
+class MctsPlayer : public DuelBot {
+public:
+    MctsBot bot;
+
+    MctsPlayer(const Race& race, SearchBudget modelBudget, SearchBudget botBudget) :
+            bot(race, SearchBudget::rollouts(modelBudget.amount + botBudget.amount)) {}
+
+    void seed(uint64_t, uint64_t botSeed) {
+        bot.seed(botSeed);
+    }
+
+    PairOutput move(GameState& gameState) {
+        return bot.move(gameState);
+    }
+
+    int rolloutCount() const {
+        return bot.rolloutCount();
+    }
+
+    // MctsBot doesn't screen or cache its rollouts.
+    EditScreen::Stats screenStats() const {
+        return EditScreen::Stats();
+    }
+
+    ScoreCache::Stats cacheStats() const {
+        return ScoreCache::Stats();
+    }
+};
+
+struct MapResult {
+    // The challenger as player B, then as player A.
+    double asB;
+    double asA;
+};
+
+template<typename Challenger>
+static MapResult playMap(const Race& race, uint64_t seed, SearchBudget modelBudget, SearchBudget botBudget) {
+    MapResult result;
+    {
+        Simulation sim(race, seed);
+        AnnealingPlayer a(race, modelBudget, botBudget);
+        Challenger b(race, modelBudget, botBudget);
+        result.asB = sim.fullGame(a, b, false);
+    }
+    {
+        Simulation sim(race, seed);
+        Challenger a(race, modelBudget, botBudget);
+        AnnealingPlayer b(race, modelBudget, botBudget);
+        result.asA = -sim.fullGame(a, b, false);
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int games = 16;
+    int threads = max(1u, thread::hardware_concurrency());
+    uint64_t seed = 1;
+    string corpusPath;
+    long modelRollouts = 2000;
+    long botRollouts = 6000;
+    bool verbose = false;
+    string challenger = "genetic";
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--challenger") == 0 && i + 1 < argc) {
+            challenger = argv[++i];
+        } else if(strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = max(1, atoi(argv[++i]));
+        } else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpusPath = argv[++i];
+        } else if(strcmp(argv[i], "--model-rollouts") == 0 && i + 1 < argc) {
+            modelRollouts = atol(argv[++i]);
+        } else if(strcmp(argv[i], "--bot-rollouts") == 0 && i + 1 < argc) {
+            botRollouts = atol(argv[++i]);
+        } else if(strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else {
+            cerr << "Unknown argument: " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if(games <= 0) {
+        cerr << "Need at least one game." << endl;
+        return 1;
+    }
+    if(challenger != "genetic" && challenger != "mcts" && challenger != "beam") {
+        cerr << "Unknown challenger: " << challenger << endl;
+        return 1;
+    }
+
+    vector<Race> races;
+    if(!corpusPath.empty()) {
+        RaceCorpus corpus;
+        if(!corpus.load(corpusPath) || corpus.empty()) {
+            cerr << "Could not load race corpus: " << corpusPath << endl;
+            return 1;
+        }
+        for(int g = 0; g < games; g++) {
+            races.push_back(corpus.race(g % corpus.size()));
+        }
+    } else {
+        RaceGenerator generator(seed);
+        for(int g = 0; g < games; g++) {
+            races.push_back(generator.generate(g));
+        }
+    }
+
+    streambuf* cerrBuf = cerr.rdbuf();
+    if(!verbose) cerr.rdbuf(nullptr);
+    SearchBudget modelBudget = SearchBudget::rollouts(modelRollouts);
+    SearchBudget botBudget = SearchBudget::rollouts(botRollouts);
+    vector<MapResult> results(games);
+    atomic<int> nextGame(0);
+    auto worker = [&]() {
+        for(int g = nextGame++; g < games; g = nextGame++) {
+            uint64_t gameSeed = Random::mix(seed, g);
+            if(challenger == "mcts") {
+                results[g] = playMap<MctsPlayer>(races[g], gameSeed, modelBudget, botBudget);
+            } else if(challenger == "beam") {
+                results[g] = playMap<BeamPlayer>(races[g], gameSeed, modelBudget, botBudget);
+            } else {
+                results[g] = playMap<GeneticPlayer>(races[g], gameSeed, modelBudget, botBudget);
+            }
+        }
+    };
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++) {
+        workers.push_back(thread(worker));
+    }
+    for(thread& t : workers) {
+        t.join();
+    }
+    cerr.clear();
+    cerr.rdbuf(cerrBuf);
+
+    int wins = 0;
+    int losses = 0;
+    double sum = 0;
+    double sumSq = 0;
+    for(int g = 0; g < games; g++) {
+        cout << "Map " << g << ": " << results[g].asB << " (as B), " << results[g].asA << " (as A)" << endl;
+        for(double score : {results[g].asB, results[g].asA}) {
+            if(score > 0) wins++;
+            if(score < 0) losses++;
+            sum += score;
+            sumSq += score * score;
+        }
+    }
+    int played = 2 * games;
+    double mean = sum / played;
+    double sd = sqrt(max(0.0, sumSq / played - mean * mean));
+    cout << challenger << " vs annealing over " << played << " games: " << wins << " wins, " << losses << " losses, "
+         << "mean score " << mean << " +/- " << sd / sqrt(played) << endl;
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+
+#include "CMAES.h"
+
+using namespace std;
+
+TEST(CMAESTest, converges_on_shifted_sphere) {
+    int n = 14;
+    vector<double> start(n, 0.0);
+    vector<double> lower(n, -10.0);
+    vector<double> upper(n, 10.0);
+    vector<double> optimum(n);
+    for(int i = 0; i < n; i++) optimum[i] = -5.0 + i * 0.7;
+    SepCMAES cma(start, lower, upper, 0.3, 42);
+    for(int gen = 0; gen < 400; gen++) {
+        vector<vector<double>> population = cma.ask();
+        vector<double> costs;
+        for(auto& x : population) {
+            double c = 0;
+            for(int i = 0; i < n; i++) c += (x[i] - optimum[i]) * (x[i] - optimum[i]);
+            costs.push_back(c);
+        }
+        cma.tell(population, costs);
+    }
+    vector<double> mean = cma.mean();
+    for(int i = 0; i < n; i++) {
+        EXPECT_NEAR(optimum[i], mean[i], 0.01);
+    }
+}
+
+TEST(CMAESTest, samples_respect_bounds) {
+    // Optimum sits outside the box; the mean should be pushed against the bound but samples never leave it.
+    vector<double> start = {1000, 0.5};
+    vector<double> lower = {0, -1};
+    vector<double> upper = {6000, 0};
+    SepCMAES cma(start, lower, upper, 0.3, 7);
+    for(int gen = 0; gen < 100; gen++) {
+        vector<vector<double>> population = cma.ask();
+        vector<double> costs;
+        for(auto& x : population) {
+            ASSERT_GE(x[0], lower[0]);
+            ASSERT_LE(x[0], upper[0]);
+            ASSERT_GE(x[1], lower[1]);
+            ASSERT_LE(x[1], upper[1]);
+            costs.push_back(-x[0] + x[1]);
+        }
+        cma.tell(population, costs);
+    }
+    EXPECT_NEAR(6000, cma.mean()[0], 60);
+    EXPECT_NEAR(-1, cma.mean()[1], 0.01);
+}
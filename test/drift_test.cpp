@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "Drift.h"
+#include "Physics.h"
+
+class DriftTest : public ::testing::Test {
+protected:
+    Race race;
+    Physics physics;
+
+    DriftTest() : race(3, {Vector(0, 0), Vector(15000, 8000)}), physics(race) {}
+};
+
+TEST_F(DriftTest, tables_match_pow) {
+    for(int k = 0; k <= Drift::TABLE_TURNS + 2; k++) {
+        EXPECT_NEAR(std::pow(DRAG, k), Drift::dragPower(k), 1e-5) << k;
+        EXPECT_NEAR((1 - std::pow(DRAG, k)) / (1 - DRAG), Drift::dragSum(k), 1e-4) << k;
+    }
+}
+
+TEST_F(DriftTest, follows_stepped_physics) {
+    // A pod already facing its thrust direction keeps the same thrust vector.
+    float angle = 0.5;
+    PodState pod(Vector(3000, 2000), Vector(-150, 320), angle, 1);
+    Vector relativeForce = Vector::fromMagAngle(1000, angle);
+    Drift drift(pod.pos, pod.vel, Vector::fromMagAngle(MAX_THRUST, angle));
+    PodState stepped = pod;
+    for(int k = 1; k <= 10; k++) {
+        stepped = physics.move(stepped, PodOutputAbs(MAX_THRUST, stepped.pos + relativeForce), 1);
+        // The game truncates to integers every turn, which the closed form doesn't.
+        EXPECT_NEAR(stepped.pos.x, drift.position(k).x, 4 * k);
+        EXPECT_NEAR(stepped.pos.y, drift.position(k).y, 4 * k);
+        EXPECT_NEAR(stepped.vel.x, drift.velocity(k).x, 6);
+        EXPECT_NEAR(stepped.vel.y, drift.velocity(k).y, 6);
+    }
+}
+
+TEST_F(DriftTest, first_turn_within) {
+    Drift coasting(Vector(0, 0), Vector(600, 0), Vector(0, 0));
+    // Positions: 600, 1110, 1543.5, 1912, ... and never beyond 4000.
+    EXPECT_EQ(0, coasting.firstTurnWithin(Vector(100, 0), 200, 10));
+    EXPECT_EQ(3, coasting.firstTurnWithin(Vector(1500, 50), 100, 10));
+    // Passes through the circle during turn 4.
+    EXPECT_EQ(4, coasting.firstTurnWithin(Vector(1700, 50), 100, 10));
+    EXPECT_EQ(-1, coasting.firstTurnWithin(Vector(1700, 50), 100, 3));
+    EXPECT_EQ(-1, coasting.firstTurnWithin(Vector(5000, 0), 100, 60));
+    EXPECT_EQ(-1, coasting.firstTurnWithin(Vector(1700, 500), 100, 10));
+
+    Drift thrusting(Vector(0, 0), Vector(600, 0), Vector(MAX_THRUST, 0));
+    for(int k = 1; k < 10; k++) {
+        EXPECT_EQ(k, thrusting.firstTurnWithin(thrusting.position(k), 1, 10));
+    }
+}
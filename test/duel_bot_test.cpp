@@ -2,6 +2,9 @@
 #include "InputParser.h"
 
 #include "AnnealingBot.h"
+#include "GeneticBot.h"
+#include "BeamBot.h"
+#include "MctsBot.h"
 
 using namespace std;
 
@@ -93,6 +96,83 @@ TEST(DuelBotTestNoFixture, annealing_bot_progess) {
     ASSERT_GT(bot.progress(&cur, &prev), prevScore);
 }
 
+static void expectSameMove(const PairOutput& a, const PairOutput& b) {
+    EXPECT_EQ(a.o1.thrust, b.o1.thrust);
+    EXPECT_EQ(a.o1.angle, b.o1.angle);
+    EXPECT_EQ(a.o2.thrust, b.o2.thrust);
+    EXPECT_EQ(a.o2.angle, b.o2.angle);
+}
+
+TEST_F(DuelBotTest, rollout_budget_is_reproducible) {
+    PairOutput moves[2];
+    for(int i = 0; i < 2; i++) {
+        AnnealingBot<6> bot(r, SearchBudget::rollouts(3000));
+        bot.seed(42);
+        moves[i] = bot.move(gs);
+    }
+    expectSameMove(moves[0], moves[1]);
+}
+
+TEST_F(DuelBotTest, genetic_bot_rollout_budget_is_reproducible) {
+    PairOutput moves[2];
+    for(int i = 0; i < 2; i++) {
+        GeneticBot<6> bot(r, SearchBudget::rollouts(3000));
+        bot.seed(42);
+        moves[i] = bot.move(gs);
+        EXPECT_EQ(3000, bot.rolloutCount());
+    }
+    expectSameMove(moves[0], moves[1]);
+}
+
+TEST_F(DuelBotTest, mcts_bot_searches_within_a_full_arena) {
+    // An arena far smaller than the rollout budget: once it's full, iterations must carry on without growing the tree.
+    PairOutput moves[2];
+    for(int i = 0; i < 2; i++) {
+        MctsBot bot(r, SearchBudget::rollouts(3000), 256);
+        bot.seed(42);
+        moves[i] = bot.move(gs);
+        EXPECT_EQ(3000, bot.rolloutCount());
+        EXPECT_EQ(256, bot.arenaSize());
+        EXPECT_EQ(0, bot.freeNodeCount());
+        // The arena filled within the first 256 iterations, and every one after it still ran.
+        EXPECT_GE(bot.fullArenaIterations(), 3000 - 256);
+    }
+    expectSameMove(moves[0], moves[1]);
+}
+
+TEST_F(DuelBotTest, mcts_bot_reuses_the_subtree_the_turn_went_down) {
+    MctsBot bot(r, SearchBudget::rollouts(3000));
+    bot.seed(42);
+    PairOutput ours = bot.move(gs);
+    EXPECT_EQ(0, bot.reusedRolloutCount());
+    // Play the turn as the tree has it: our move, with the opponent racing (one of its actions).
+    GameState next = gs;
+    PodState* pods[] = {&next.ourState().pods[0], &next.ourState().pods[1], &next.enemyState().pods[0],
+                        &next.enemyState().pods[1]};
+    PodOutputSim enemy[] = {bot.output(*pods[2], MctsBot::RACE), bot.output(*pods[3], MctsBot::RACE)};
+    Physics::apply(*pods[0], ours.o1);
+    Physics::apply(*pods[1], ours.o2);
+    Physics::apply(*pods[2], enemy[0]);
+    Physics::apply(*pods[3], enemy[1]);
+    Physics(r).simulate(pods);
+    bot.move(next);
+    EXPECT_GT(bot.reusedRolloutCount(), 0);
+    // Pods far from anything the tree predicted start a new tree.
+    GameState elsewhere = next;
+    elsewhere.ourState().pods[0].pos = elsewhere.ourState().pods[0].pos + Vector(3000, 0);
+    bot.move(elsewhere);
+    EXPECT_EQ(0, bot.reusedRolloutCount());
+}
+
+TEST_F(DuelBotTest, beam_bot_fits_its_width_to_the_rollout_budget) {
+    BeamBot<8> bot(r, SearchBudget::rollouts(3000));
+    bot.move(gs);
+    // 3000 rollouts over 8 depths of 49 children, plus the kept ones' replays: 7 wide.
+    EXPECT_EQ(7, bot.beamWidth());
+    EXPECT_EQ(8, bot.searchDepth());
+    EXPECT_LE(bot.rolloutCount(), 3000);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
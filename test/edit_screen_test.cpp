@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include "EditScreen.h"
+
+TEST(EditScreenTest, skips_only_edits_that_are_always_rejected) {
+    EditScreen screen;
+    PodOutputSim straight(MAX_THRUST, 0, false, false);
+    PairOutput before(straight, straight);
+    // Slowing the bouncer on turn 3 is always rejected, turning the racer on turn 1 always accepted.
+    PairOutput slower(straight, PodOutputSim(20, 0, false, false));
+    PairOutput turned(PodOutputSim(MAX_THRUST, 0.2f, false, false), straight);
+    int turnedSkipped = 0;
+    for(int i = 0; i < 4000; i++) {
+        bool reject = i % 2 == 0;
+        screen.describe(before, reject ? slower : turned, reject ? 3 : 1, i / 4000.0f);
+        if(screen.shouldRollOut()) {
+            screen.learn(!reject);
+        } else if(!reject) {
+            turnedSkipped++;
+        }
+    }
+    const EditScreen::Stats& stats = screen.stats();
+    EXPECT_EQ(0, turnedSkipped);
+    EXPECT_EQ(4000, stats.proposals);
+    EXPECT_GT(stats.skipped, 1000);
+    // Some of what it would skip is still rolled out, which is what it is measured on.
+    EXPECT_NEAR(stats.skipped / (screen.auditPeriod - 1), stats.audited, 2);
+    EXPECT_EQ(1, stats.precision());
+    // What it lets through is mostly what it learnt from before it skipped anything.
+    EXPECT_GT(stats.recall(), 0.6);
+
+    screen.reset();
+    EXPECT_EQ(0, screen.stats().proposals);
+    screen.describe(before, slower, 3, 0.5f);
+    EXPECT_TRUE(screen.shouldRollOut());
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "EndgameSolver.h"
+
+class EndgameSolverTest : public ::testing::Test {
+protected:
+    Race race;
+    EndgameSolver solver;
+    // Nowhere near the racer.
+    PodState farAway[3] = {PodState(Vector(0, 30000), Vector(0, 0), 0, 1),
+                           PodState(Vector(30000, 30000), Vector(0, 0), 0, 1),
+                           PodState(Vector(-30000, 30000), Vector(0, 0), 0, 1)};
+
+    EndgameSolverTest() : race(3, {Vector(0, 0), Vector(8000, 0)}), solver(race) {}
+
+    // On its last checkpoint, the first one, and facing it.
+    PodState racer(Vector pos, Vector vel, bool boost) {
+        PodState pod(pos, vel, Physics::angleTo(pos, race.checkpoints[0]), 0);
+        pod.passedCheckpoints = race.totalCPCount() - 1;
+        pod.boostAvailable = boost;
+        return pod;
+    }
+};
+
+TEST_F(EndgameSolverTest, applies_on_the_last_checkpoint_only) {
+    PodState pod = racer(Vector(5000, 0), Vector(0, 0), false);
+    EXPECT_TRUE(solver.applies(pod));
+    pod.passedCheckpoints--;
+    EXPECT_FALSE(solver.applies(pod));
+}
+
+TEST_F(EndgameSolverTest, boost_makes_the_plan_faster) {
+    EndgameSolver::Plan withoutBoost;
+    EndgameSolver::Plan withBoost;
+    ASSERT_TRUE(solver.solve(racer(Vector(5000, 0), Vector(0, 0), false), farAway, 3, withoutBoost));
+    ASSERT_TRUE(solver.solve(racer(Vector(5000, 0), Vector(0, 0), true), farAway, 3, withBoost));
+    EXPECT_LT(withBoost.turns, withoutBoost.turns);
+    // Full thrust straight on from standing covers the 4400 units to the checkpoint in 8 turns.
+    EXPECT_EQ(8, withoutBoost.turns);
+    EXPECT_EQ(MAX_THRUST, withoutBoost.first.thrust);
+}
+
+TEST_F(EndgameSolverTest, declines_when_someone_can_get_in_the_way) {
+    PodState blocker[] = {PodState(Vector(2500, 0), Vector(0, 0), 0, 1)};
+    EndgameSolver::Plan plan;
+    EXPECT_FALSE(solver.solve(racer(Vector(5000, 0), Vector(0, 0), false), blocker, 1, plan));
+}
@@ -2,8 +2,10 @@
 // Created by Kevin on 1/08/2016.
 //
 
+#include <unistd.h>
 #include "gtest/gtest.h"
 #include "InputParser.h"
+#include "FastIO.h"
 
 using namespace std;
 
@@ -56,3 +58,53 @@ TEST_F(InputParserTest, basic) {
         EXPECT_FLOAT_EQ(angle1, players[OUR_PLAYER_ID].pods[0].angle);
 }
 
+
+TEST_F(InputParserTest, fast_input_matches_stream) {
+        int fds[2];
+        ASSERT_EQ(0, pipe(fds));
+        string all = inputStr + "-5 -12 3 -4 359 1\n";
+        ASSERT_EQ((ssize_t) all.size(), write(fds[1], all.data(), all.size()));
+        close(fds[1]);
+
+        FastInput input(fds[0]);
+        InputParser fast(input);
+        istringstream stream(inputStr);
+        InputParser slow(stream);
+        Race fastRace = fast.init();
+        Race slowRace = slow.init();
+        EXPECT_EQ(slowRace.laps, fastRace.laps);
+        EXPECT_EQ(slowRace.checkpoints, fastRace.checkpoints);
+        input.beginTurn();
+        EXPECT_GT(input.turnArrival(), 0);
+        PlayerState fastPlayers[PLAYER_COUNT];
+        PlayerState slowPlayers[PLAYER_COUNT];
+        fast.parseTurn(fastPlayers);
+        slow.parseTurn(slowPlayers);
+        for(int i = 0; i < PLAYER_COUNT; i++) {
+            for(int p = 0; p < POD_COUNT; p++) {
+                EXPECT_EQ(slowPlayers[i].pods[p], fastPlayers[i].pods[p]);
+            }
+        }
+        EXPECT_EQ(-5, input.readInt());
+        EXPECT_EQ(-12, input.readInt());
+        EXPECT_EQ(3, input.readInt());
+        EXPECT_EQ(-4, input.readInt());
+        EXPECT_EQ(359, input.readInt());
+        EXPECT_EQ(1, input.readInt());
+        EXPECT_TRUE(input.eof());
+        close(fds[0]);
+}
+
+TEST(FastOutputTest, matches_to_string) {
+        PodOutputAbs move(87.6f, Vector(1234.4f, -56.5f));
+        PodOutputAbs boost(0, Vector(0, 9000));
+        boost.enableBoost();
+        PodOutputAbs shield(0, Vector(15999.7f, 3));
+        shield.enableShield();
+        FastOutput output(-1);
+        output.write(move);
+        output.write(boost);
+        output.write(shield);
+        string expected = move.toString() + "\n" + boost.toString() + "\n" + shield.toString() + "\n";
+        EXPECT_EQ(expected, string(output.data(), output.size()));
+}
@@ -4,6 +4,7 @@
 
 #include "gtest/gtest.h"
 #include "Navigation.h"
+#include "Physics.h"
 
 TEST(NavigationTest, seek_thrust_below_max) {
     Race r;
@@ -27,8 +28,8 @@ TEST(NavigationTest, seek_thrust_below_max) {
 }
 
 TEST(NavigationTest, turn_saturation_adjusted) {
-    Navigation nav(Race(1, {}));
     Race r(1, {});
+    Navigation nav(r);
     Vector pos(200, 200);
     Vector vel(200, 0);
     Vector target(400, 400);
@@ -51,9 +52,26 @@ TEST(NavigationTest, turn_saturation_adjusted) {
 }
 
 
+// Turns until reached, stepping seek all the way.
+static int steppedTurnsUntilReached(Race &r, const PodState &podInit, Vector target, float withinDist) {
+    Navigation nav(r);
+    Physics physics(r);
+    PodState pod = podInit;
+    PodState previous = podInit;
+    int i = 0;
+    while((target - pod.pos).getLength() > withinDist &&
+          !physics.passedPoint(previous.pos, pod.pos, target, withinDist) && i < 30) {
+        previous = pod;
+        pod = physics.move(pod, nav.turnSaturationAdjust(pod, nav.seek(pod, target)), 1);
+        i++;
+    }
+    return i;
+}
+
 TEST(NavigationTest, turnsUntilReached) {
     // Need to specific at least 1 checkpoint or the physic's move method will have undefined behaviour.
-    Navigation nav(Race(1, {Vector(0,0)}));
+    Race r(1, {Vector(0,0)});
+    Navigation nav(r);
     Vector pos(200, 0);
     Vector vel(100, 0);
     float angle = 0;
@@ -61,12 +79,32 @@ TEST(NavigationTest, turnsUntilReached) {
     PodState ps(pos, vel, angle, 0);
     float withinDist = 100;
     int turns = nav.turnsUntilReached(ps, target, withinDist);
-    int precalculatedAns = 4;
-    EXPECT_EQ(precalculatedAns, turns);
+    // Seeking stops thrusting on the third turn, as it would overshoot; the prediction keeps thrusting.
+    EXPECT_EQ(3, steppedTurnsUntilReached(r, ps, target, withinDist));
+    EXPECT_EQ(2, turns);
+}
+
+TEST(NavigationTest, turnsUntilReached_while_turning) {
+    // The pod has to turn towards the target first, at most 18 degrees a turn, and to kill its sideways speed.
+    Race r(1, {Vector(0,0)});
+    Navigation nav(r);
+    float angles[] = {0.3, 2.0, 2.8, 3.0};
+    Vector vels[] = {Vector(0, 0), Vector(-300, 0), Vector(200, -200)};
+    for(float angle : angles) {
+        for(Vector vel : vels) {
+            for(int dist = 2000; dist <= 8000; dist += 3000) {
+                PodState ps(Vector(0, 0), vel, angle, 0);
+                Vector target(dist / 2, dist);
+                EXPECT_EQ(steppedTurnsUntilReached(r, ps, target, 600), nav.turnsUntilReached(ps, target, 600))
+                        << "angle " << angle << ", velocity (" << vel.x << ", " << vel.y << "), distance " << dist;
+            }
+        }
+    }
 }
 
 TEST(NavigationTest, findIntecept) {
-    Navigation nav(Race(1, {Vector(0,0)}));
+    Race r(1, {Vector(0,0)});
+    Navigation nav(r);
     Vector pos(9335, 977);
     Vector vel(0, 0);
     float angle = M_PI * (145 / 180);
@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "OpeningBook.h"
+#include "Simulation.h"
+
+class OpeningBookTest : public ::testing::Test {
+protected:
+    Race race;
+    PodState aPods[POD_COUNT];
+    PodState bPods[POD_COUNT];
+    PairOutput plan[OpeningBook::PLAN_TURNS];
+
+    OpeningBookTest() : race(3, {Vector(2000, 2000), Vector(12000, 7000), Vector(9000, 1500)}) {
+        Simulation(race).initializePods(aPods, bPods);
+        for(int t = 0; t < OpeningBook::PLAN_TURNS; t++) {
+            plan[t] = PairOutput(PodOutputSim(MAX_THRUST - 10 * t, Physics::degreesToRad(-12.5f), false, t == 0),
+                                 PodOutputSim(0, Physics::degreesToRad(3), t == 2, false));
+        }
+    }
+};
+
+TEST_F(OpeningBookTest, plans_survive_the_file_by_side) {
+    OpeningBook book;
+    book.add(OpeningBook::layoutKey(race, aPods), plan);
+    string path = testing::TempDir() + "opening_book_test.bin";
+    ASSERT_TRUE(book.save(path));
+    OpeningBook loaded;
+    ASSERT_TRUE(loaded.load(path));
+    remove(path.c_str());
+
+    PairOutput found[OpeningBook::PLAN_TURNS];
+    ASSERT_TRUE(loaded.lookup(race, aPods, found));
+    for(int t = 0; t < OpeningBook::PLAN_TURNS; t++) {
+        EXPECT_EQ(plan[t].o1.thrust, found[t].o1.thrust);
+        EXPECT_NEAR(plan[t].o1.angle, found[t].o1.angle, 1e-4);
+        EXPECT_EQ(plan[t].o1.boostEnabled, found[t].o1.boostEnabled);
+        EXPECT_EQ(plan[t].o2.shieldEnabled, found[t].o2.shieldEnabled);
+    }
+    // The other side of the grid, and the same grid on another race, get the generic plan.
+    EXPECT_FALSE(loaded.lookup(race, bPods, found));
+    EXPECT_EQ(MAX_THRUST, found[0].o1.thrust);
+    EXPECT_EQ(0, found[0].o1.angle);
+    Race other(2, {Vector(2000, 2000), Vector(12000, 7000), Vector(9000, 1500)});
+    EXPECT_FALSE(loaded.lookup(other, aPods, found));
+}
+
+TEST_F(OpeningBookTest, header_is_only_written_when_it_fits) {
+    OpeningBook book;
+    book.add(OpeningBook::layoutKey(race, aPods), plan);
+    book.add(OpeningBook::layoutKey(race, bPods), plan);
+    string path = testing::TempDir() + "opening_book_test.h";
+    EXPECT_FALSE(book.saveHeader(path, 300));
+    EXPECT_EQ(nullptr, fopen(path.c_str(), "r"));
+    EXPECT_TRUE(book.saveHeader(path, 5000));
+    remove(path.c_str());
+}
@@ -0,0 +1,84 @@
+#include <cstdio>
+#include "gtest/gtest.h"
+
+#include "Physics.h"
+#include "PhysicsRegression.h"
+
+using namespace std;
+
+class PhysicsRegressionTest : public ::testing::Test {
+protected:
+    Race race = Race(3, {Vector(2000, 2000), Vector(8000, 3000), Vector(5000, 7000)});
+    string path = "physics_regression_test.csbr";
+    PodState pods[4];
+    PodState* podPtrs[4] = {&pods[0], &pods[1], &pods[2], &pods[3]};
+
+    PhysicsRegressionTest() {
+        // Two pods start overlapping paths so the recording includes collisions.
+        pods[0] = PodState(Vector(2000, 1500), Vector(0, 0), 0, 1);
+        pods[1] = PodState(Vector(2000, 2500), Vector(0, 0), 0, 1);
+        pods[2] = PodState(Vector(3500, 1500), Vector(0, 0), M_PI, 1);
+        pods[3] = PodState(Vector(3500, 2500), Vector(0, 0), M_PI, 1);
+    }
+
+    ~PhysicsRegressionTest() {
+        remove(path.c_str());
+    }
+
+    /**
+     * Records a few turns played by Physics itself. If corruptTurn is set, the pods recorded after that turn are moved.
+     */
+    void record(int turns, int corruptTurn = -1) {
+        Physics physics(race);
+        ReplayWriter writer;
+        ASSERT_TRUE(writer.open(path, race));
+        PairOutput out(PodOutputSim(150, 0.1f, false, false), PodOutputSim(200, -0.1f, false, false));
+        for(int t = 0; t < turns; t++) {
+            writer.writeTurn(podPtrs, &out, &out);
+            Physics::apply(pods, out);
+            Physics::apply(pods + 2, out);
+            physics.simulate(podPtrs);
+            if(t == corruptTurn) pods[1].pos += Vector(3, 4);
+        }
+        writer.writeTurn(podPtrs);
+    }
+};
+
+TEST_F(PhysicsRegressionTest, reproduces_own_recording) {
+    record(10);
+    PhysicsRegression regression;
+    ASSERT_EQ(1, regression.addPath(path));
+    EXPECT_EQ(10, regression.caseCount());
+    RegressionReport report = regression.check();
+    EXPECT_EQ(10, report.turns);
+    EXPECT_EQ(10, report.exactTurns);
+    EXPECT_EQ(0, report.posError.max);
+    EXPECT_EQ(0, report.velError.max);
+    EXPECT_EQ(40, report.posError.counts[0]);
+}
+
+TEST_F(PhysicsRegressionTest, reports_divergence) {
+    record(10, 4);
+    PhysicsRegression regression;
+    regression.addPath(path);
+    RegressionReport report = regression.check();
+    // The corrupted turn mismatches on the way in; the next turn starts from the corrupted state and is exact again.
+    EXPECT_EQ(9, report.exactTurns);
+    EXPECT_FLOAT_EQ(5, report.posError.max);
+    // 5 lies in the (4, 8] bucket.
+    EXPECT_EQ(1, report.posError.counts[4]);
+}
+
+TEST(ErrorHistogramTest, buckets) {
+    ErrorHistogram h;
+    h.add(0);
+    h.add(0.5f);
+    h.add(1);
+    h.add(1.5f);
+    h.add(1e6f);
+    EXPECT_EQ(1, h.counts[0]);
+    EXPECT_EQ(2, h.counts[1]);
+    EXPECT_EQ(1, h.counts[2]);
+    EXPECT_EQ(1, h.counts[ErrorHistogram::BUCKETS - 1]);
+    EXPECT_EQ(5, h.total);
+}
@@ -196,6 +196,59 @@ TEST_F(PhysicsTest, simulate_collision) {
     EXPECT_EQ(Vector(300*0.85, 0), b.vel);
 }
 
+TEST_F(PhysicsTest, cull_pairs) {
+    PodState a(Vector(0, 0), Vector(300, 0), 0);
+    PodState b(Vector(1200, 0), Vector(-300, 0), 0);
+    PodState far[2] = {PodState(Vector(15000, 8000), Vector(0, 0), 0), PodState(Vector(15000, 0), Vector(0, 0), 0)};
+    PodState* pods[] = {&a, &b, &far[0], &far[1]};
+    EXPECT_TRUE(Physics::canMeet(a, b, 1));
+    EXPECT_FALSE(Physics::canMeet(a, far[1], 1));
+
+    int culled = Physics::cullPairs(pods, 3);
+    EXPECT_FALSE(culled & Physics::pairBit(0, 1));
+    EXPECT_TRUE(culled & Physics::pairBit(0, 2));
+    EXPECT_FALSE(Physics::isIsolated(culled, 0));
+    EXPECT_TRUE(Physics::isIsolated(culled, 2));
+    // The far pods can reach each other in time.
+    EXPECT_FALSE(Physics::isIsolated(Physics::cullPairs(pods, 10), 2));
+
+    // a and b collide, so their pairs are no longer culled.
+    physics->simulate(pods, culled);
+    EXPECT_EQ(Vector(100, 0), a.pos);
+    EXPECT_EQ(0, culled & (Physics::podPairs(0) | Physics::podPairs(1)));
+    EXPECT_TRUE(culled & Physics::pairBit(2, 3));
+}
+
+TEST_F(PhysicsTest, simulate_alone_matches_simulate) {
+    // a and b collide; c passes a checkpoint on its own, and d is changed afterwards.
+    PodState a(Vector(0, 0), Vector(300, 0), 0);
+    PodState b(Vector(1200, 0), Vector(-300, 0), 0);
+    PodState c(Vector(5000, 5000), Vector(321, 123), 0, 1);
+    PodState d(Vector(-3000, -3000), Vector(0, 0), 0);
+    c.pos = race->checkpoints[1] - Vector(700, 100);
+    PodState* pods[] = {&a, &b, &c, &d};
+    PodState before[] = {a, b, c, d};
+    TurnLog log;
+    int culled = 0;
+    physics->simulate(pods, culled, &log);
+    EXPECT_EQ(2, log.substeps);
+    EXPECT_EQ(0x3, log.collided);
+
+    PodState alone = before[2];
+    EXPECT_TRUE(physics->simulateAlone(alone, 2, log));
+    EXPECT_EQ(c.pos, alone.pos);
+    EXPECT_EQ(c.vel, alone.vel);
+    EXPECT_EQ(c.nextCheckpoint, alone.nextCheckpoint);
+    EXPECT_EQ(1, alone.passedCheckpoints);
+
+    // Pods that collided can't be replayed alone, and neither can one that now runs into another.
+    PodState collided = before[0];
+    EXPECT_FALSE(physics->simulateAlone(collided, 0, log));
+    PodState intruder = before[3];
+    intruder.pos = Vector(600, 650);
+    EXPECT_FALSE(physics->simulateAlone(intruder, 3, log));
+}
+
 TEST_F(PhysicsTest, passed_circle_at) {
     Vector checkpoint(2200, 0);
     bool passed = physics->passedCheckpoint(Vector(0,0), Vector(1500, 0), checkpoint);
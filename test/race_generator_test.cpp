@@ -0,0 +1,70 @@
+#include <cstdio>
+#include "gtest/gtest.h"
+
+#include "RaceGenerator.h"
+
+using namespace std;
+
+TEST(RaceGeneratorTest, follows_game_rules) {
+    RaceGenerator generator(1234);
+    for(int i = 0; i < 1000; i++) {
+        Race race = generator.generate(i);
+        ASSERT_EQ(RACE_LAPS, race.laps);
+        ASSERT_GE(race.checkpoints.size(), MIN_CHECKPOINTS);
+        ASSERT_LE(race.checkpoints.size(), MAX_CHECKPOINTS);
+        for(int a = 0; a < race.checkpoints.size(); a++) {
+            const Vector& cp = race.checkpoints[a];
+            ASSERT_GE(cp.x, generator.border);
+            ASSERT_LE(cp.x, MAP_WIDTH - generator.border);
+            ASSERT_GE(cp.y, generator.border);
+            ASSERT_LE(cp.y, MAP_HEIGHT - generator.border);
+            for(int b = a + 1; b < race.checkpoints.size(); b++) {
+                ASSERT_GE(Vector::dist(cp, race.checkpoints[b]), generator.minSpacing);
+            }
+        }
+    }
+}
+
+TEST(RaceGeneratorTest, races_depend_only_on_seed_and_index) {
+    RaceGenerator a(99);
+    RaceGenerator b(99);
+    // Generate in a different order; each race must still match.
+    vector<Vector> late = b.generateCheckpoints(57);
+    vector<Vector> early = b.generateCheckpoints(3);
+    EXPECT_EQ(a.generateCheckpoints(3), early);
+    EXPECT_EQ(a.generateCheckpoints(57), late);
+    EXPECT_NE(a.generateCheckpoints(3), a.generateCheckpoints(4));
+}
+
+TEST(RaceGeneratorTest, gives_up_when_checkpoints_cannot_fit) {
+    RaceGenerator generator(5);
+    generator.border = 4000;
+    generator.minSpacing = 5000;
+    EXPECT_TRUE(generator.generateCheckpoints(0).empty());
+}
+
+TEST(RaceCorpusTest, save_and_load_round_trip) {
+    RaceCorpus corpus = RaceCorpus::generate(7, 50);
+    string path = "race_corpus_test.bin";
+    ASSERT_TRUE(corpus.save(path));
+    RaceCorpus loaded;
+    ASSERT_TRUE(loaded.load(path));
+    remove(path.c_str());
+    ASSERT_EQ(corpus.size(), loaded.size());
+    EXPECT_EQ(7u, loaded.generatorSeed());
+    for(int i = corpus.size() - 1; i >= 0; i--) {
+        EXPECT_EQ(corpus.race(i).checkpoints, loaded.race(i).checkpoints);
+        EXPECT_EQ(corpus.race(i).laps, loaded.race(i).laps);
+    }
+}
+
+TEST(RaceCorpusTest, rejects_unknown_files) {
+    string path = "race_corpus_bad.bin";
+    FILE* f = fopen(path.c_str(), "wb");
+    fputs("not a corpus", f);
+    fclose(f);
+    RaceCorpus corpus;
+    EXPECT_FALSE(corpus.load(path));
+    EXPECT_TRUE(corpus.empty());
+    remove(path.c_str());
+}
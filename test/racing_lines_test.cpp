@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "RacingLines.h"
+
+class RacingLinesTest : public ::testing::Test {
+protected:
+    Race race;
+    RacingLines lines;
+
+    RacingLinesTest() : race(3, {Vector(2000, 2000), Vector(12000, 7000), Vector(13000, 1500), Vector(6000, 7500)}),
+                        lines(race) {}
+};
+
+TEST_F(RacingLinesTest, every_line_passes_its_checkpoint) {
+    for(int cp = 0; cp < (int) race.checkpoints.size(); cp++) {
+        const RacingLines::Line& line = lines.into(cp);
+        ASSERT_EQ(line.controls.size() + 1, line.pods.size());
+        EXPECT_LT(line.controls.size(), (size_t) RacingLines::MAX_TURNS);
+        EXPECT_EQ(race.followingCheckpoint(cp), line.pods.back().nextCheckpoint);
+        for(const PodOutputSim& control : line.controls) {
+            EXPECT_LE(abs(control.angle), MAX_ANGLE + 1e-5);
+            EXPECT_LE(control.thrust, MAX_THRUST);
+        }
+    }
+}
+
+TEST_F(RacingLinesTest, start_seed_follows_the_first_line) {
+    PairOutput seed[3];
+    lines.startSeed(seed, 3);
+    for(int t = 0; t < 3; t++) {
+        EXPECT_EQ(lines.into(1).controls[t].thrust, seed[t].o1.thrust);
+        EXPECT_EQ(lines.into(1).controls[t].angle, seed[t].o2.angle);
+    }
+}
+
+TEST_F(RacingLinesTest, racer_on_a_line_follows_it) {
+    const RacingLines::Line& line = lines.into(2, RacingLines::ENTRY_SPEEDS - 1);
+    PodOutputSim controls[4];
+    ASSERT_TRUE(lines.match(line.pods[1], controls, 4));
+    for(int t = 0; t < 4 && t + 1 < (int) line.controls.size(); t++) {
+        EXPECT_EQ(line.controls[t + 1].thrust, controls[t].thrust);
+        EXPECT_EQ(line.controls[t + 1].angle, controls[t].angle);
+    }
+    // Nowhere near the course, and going the wrong way.
+    PodState lost(Vector(15500, 8500), Vector(-600, 0), 0, 2);
+    EXPECT_FALSE(lines.match(lost, controls, 4));
+}
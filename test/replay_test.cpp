@@ -0,0 +1,85 @@
+#include <cstdio>
+#include "gtest/gtest.h"
+
+#include "Replay.h"
+
+using namespace std;
+
+class ReplayTest : public ::testing::Test {
+protected:
+    Race race = Race(3, {Vector(1000, 1000), Vector(9000, 2000), Vector(5000, 7000)});
+    string path = "replay_test.csbr";
+    PodState pods[4];
+    PodState* podPtrs[4] = {&pods[0], &pods[1], &pods[2], &pods[3]};
+
+    ReplayTest() {
+        for(int i = 0; i < 4; i++) {
+            pods[i] = PodState(Vector(100 * i, 200 * i), Vector(10 * i, -5 * i), 0.5f * i, 1);
+            pods[i].passedCheckpoints = i;
+            pods[i].turnsSinceShield = i;
+        }
+        pods[2].shieldEnabled = true;
+        pods[3].boostAvailable = false;
+    }
+
+    ~ReplayTest() {
+        remove(path.c_str());
+    }
+};
+
+TEST_F(ReplayTest, round_trip) {
+    PairOutput aOut(PodOutputSim(200, 0.1f, false, true), PodOutputSim(0, -0.2f, true, false));
+    PairOutput bOut(PodOutputSim(50, 0.3f, false, false), PodOutputSim(100, 0, false, false));
+    {
+        ReplayWriter writer;
+        ASSERT_TRUE(writer.open(path, race));
+        writer.writeTurn(podPtrs, &aOut, &bOut);
+        pods[0].pos += Vector(1, 1);
+        writer.writeTurn(podPtrs);
+    }
+    ReplayReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_EQ(2, reader.turnCount());
+    EXPECT_EQ(race.checkpoints, reader.race().checkpoints);
+    EXPECT_EQ(race.laps, reader.race().laps);
+
+    const replay::TurnRecord& first = reader.turn(0);
+    PodState p2 = replay::unpack(first.pods[2]);
+    EXPECT_EQ(pods[2], p2);
+    EXPECT_TRUE(p2.shieldEnabled);
+    EXPECT_EQ(2, p2.passedCheckpoints);
+    EXPECT_FALSE(replay::unpack(first.pods[3]).boostAvailable);
+    PodOutputSim a1 = replay::unpack(first.actions[0]);
+    EXPECT_EQ(200, a1.thrust);
+    EXPECT_FLOAT_EQ(0.1f, a1.angle);
+    EXPECT_TRUE(a1.boostEnabled);
+    EXPECT_TRUE(replay::unpack(first.actions[1]).shieldEnabled);
+    EXPECT_TRUE(first.actions[3].flags & replay::ActionRecord::VALID);
+
+    const replay::TurnRecord& last = reader.turn(1);
+    EXPECT_EQ(pods[0], replay::unpack(last.pods[0]));
+    EXPECT_FALSE(last.actions[0].flags & replay::ActionRecord::VALID);
+}
+
+TEST_F(ReplayTest, ignores_truncated_record) {
+    {
+        ReplayWriter writer;
+        ASSERT_TRUE(writer.open(path, race));
+        writer.writeTurn(podPtrs);
+    }
+    FILE* f = fopen(path.c_str(), "ab");
+    fputs("partial", f);
+    fclose(f);
+    ReplayReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(1, reader.turnCount());
+}
+
+TEST_F(ReplayTest, rejects_other_files) {
+    FILE* f = fopen(path.c_str(), "wb");
+    for(int i = 0; i < 200; i++) fputc('x', f);
+    fclose(f);
+    ReplayReader reader;
+    EXPECT_FALSE(reader.open(path));
+    EXPECT_FALSE(reader.open("does_not_exist.csbr"));
+}
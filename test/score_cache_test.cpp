@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "ScoreCache.h"
+
+TEST(ScoreCacheTest, edits_update_the_hash_and_find_scored_solutions) {
+    PairOutput solution[6];
+    for(int t = 0; t < 6; t++) {
+        solution[t] = PairOutput(PodOutputSim(MAX_THRUST, 0, false, false), PodOutputSim(100 + t, 0.1f, false, false));
+    }
+    uint64_t key = ScoreCache::hash(solution, 6);
+    ScoreCache cache;
+    cache.clear();
+    cache.store(key, 1234);
+
+    // Editing one turn and back, by xoring its hashes in and out.
+    PairOutput saved = solution[2];
+    solution[2].o2.shieldEnabled = true;
+    uint64_t edited = key ^ ScoreCache::turnHash(2, saved) ^ ScoreCache::turnHash(2, solution[2]);
+    EXPECT_EQ(ScoreCache::hash(solution, 6), edited);
+    EXPECT_NE(key, edited);
+    float score = 0;
+    EXPECT_FALSE(cache.lookup(edited, 0.9f, score));
+    // The same controls on another turn are another solution.
+    swap(solution[2], solution[3]);
+    EXPECT_NE(edited, ScoreCache::hash(solution, 6));
+
+    EXPECT_TRUE(cache.lookup(key, 0.9f, score));
+    EXPECT_EQ(1234, score);
+    EXPECT_EQ(2, cache.stats().lookups[ScoreCache::PHASES - 1]);
+    EXPECT_EQ(0.5, cache.stats().hitRate(ScoreCache::PHASES - 1));
+    EXPECT_EQ(0, cache.stats().lookups[0]);
+
+    cache.clear();
+    EXPECT_FALSE(cache.lookup(key, 0, score));
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "State.h"
+
+class StateTest : public ::testing::Test {
+protected:
+    Race race;
+
+    StateTest() : race(3, {Vector(1000, 1000), Vector(8000, 3000), Vector(4000, 7000)}) {}
+
+    PlayerState player(int x, int y) {
+        PodState pods[POD_COUNT] = {PodState(Vector(x, y), Vector(0, 0), 0, 1),
+                                    PodState(Vector(x, y + 1000), Vector(0, 0), 0, 1)};
+        return PlayerState(pods);
+    }
+};
+
+TEST_F(StateTest, race_id_depends_on_layout) {
+    Race same(3, {Vector(1000, 1000), Vector(8000, 3000), Vector(4000, 7000)});
+    Race otherLaps(2, {Vector(1000, 1000), Vector(8000, 3000), Vector(4000, 7000)});
+    Race otherCheckpoint(3, {Vector(1000, 1000), Vector(8000, 3001), Vector(4000, 7000)});
+    EXPECT_EQ(race.id, same.id);
+    EXPECT_NE(race.id, otherLaps.id);
+    EXPECT_NE(race.id, otherCheckpoint.id);
+}
+
+TEST_F(StateTest, game_state_round_trips_through_snapshot) {
+    PlayerState players[PLAYER_COUNT] = {player(1000, 1000), player(2000, 1000)};
+    players[1].leadPodID = 1;
+    players[0].pods[0].boostAvailable = false;
+    players[0].pods[1].turnsSinceShield = 1;
+    GameState game(race, players, 17);
+
+    GameSnapshot snapshot = game.save();
+    EXPECT_EQ(race.id, snapshot.raceId);
+    GameState restored(race, snapshot);
+    EXPECT_EQ(&race, restored.race);
+    EXPECT_EQ(17, restored.turn);
+    EXPECT_EQ(0, memcmp(game.playerStates, restored.playerStates, sizeof(game.playerStates)));
+}
+
+TEST_F(StateTest, state_continues_from_restored_turn) {
+    State state(race);
+    PlayerState players[PLAYER_COUNT] = {player(1000, 1000), player(2000, 1000)};
+    state.preTurnUpdate(players);
+    state.postTurnUpdate(PodOutputAbs(100, Vector(8000, 3000)), PodOutputAbs(100, Vector(8000, 3000)));
+    GameSnapshot snapshot = state.save();
+
+    // Branch off, play on, then come back.
+    PlayerState next[PLAYER_COUNT] = {player(1500, 1000), player(2500, 1000)};
+    state.preTurnUpdate(next);
+    state.postTurnUpdate(PodOutputAbs(PodOutputAbs::SHIELD, Vector(8000, 3000)), PodOutputAbs(100, Vector(8000, 3000)));
+    state.restore(snapshot);
+
+    EXPECT_EQ(1, state.turn);
+    PlayerState again[PLAYER_COUNT] = {player(1500, 1000), player(2500, 1000)};
+    state.preTurnUpdate(again);
+    EXPECT_EQ(SHIELD_COOLDOWN + 2, state.game().ourState().pods[0].turnsSinceShield);
+    EXPECT_EQ(1, state.game().turn);
+}